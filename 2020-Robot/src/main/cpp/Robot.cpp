@@ -1,11 +1,11 @@
 #include <cameraserver/CameraServer.h>
 #include <frc/DigitalInput.h>
+#include <frc/Timer.h>
 #include <frc/smartdashboard/SendableChooser.h>
 #include <frc/smartdashboard/SmartDashboard.h>
-#include <frc/Joystick.h>
-#include <frc/XboxController.h>
 
 #include "Climber.h"
+#include "Controllers.h"
 #include "Hal.h"
 #include "Intake.h"
 #include "Launcher.h"
@@ -13,37 +13,98 @@
 #include "NavX.h"
 #include "Robot.h"
 #include "RobotMap.h"
+#include "Scheduler.h"
 #include "SwerveModule.h"
 #include "SwerveTrain.h"
 
 Climber climber(R_PWMPortClimberMotorClimb, R_PWMPortClimberMotorTranslate, R_PWMPortClimberMotorWheel, R_PWMPortClimberServoLock, R_DIOPortSwitchClimberBottom);
 frc::DigitalInput switchSwerveUnlock(R_DIOPortSwitchSwerveUnlock);
-frc::Joystick *playerOne;
-frc::XboxController *playerTwo;
+//Both drivers' controllers, read once at the start of every loop.
+Controllers controllers(R_controllerPortPlayerOne, R_controllerPortPlayerTwo);
 Intake intake(R_CANIDMotorIntake);
 Launcher launcher(R_CANIDMotorLauncherIndex, R_CANIDMotorLauncherLaunchOne, R_CANIDMotorLauncherLaunchTwo);
 Limelight limelight;
 NavX navX(NavX::ConnectionType::kMXP);
-SwerveModule frontRightModule(R_CANIDZionFrontRightDrive, R_CANIDZionFrontRightSwerve);
-SwerveModule frontLeftModule(R_CANIDZionFrontLeftDrive, R_CANIDZionFrontLeftSwerve);
-SwerveModule rearLeftModule(R_CANIDZionRearLeftDrive, R_CANIDZionRearLeftSwerve);
-SwerveModule rearRightModule(R_CANIDZionRearRightDrive, R_CANIDZionRearRightSwerve);
+SwerveModule frontRightModule(R_CANIDZionFrontRightDrive, R_CANIDZionFrontRightSwerve, R_analogPortZionFrontRightEncoder);
+SwerveModule frontLeftModule(R_CANIDZionFrontLeftDrive, R_CANIDZionFrontLeftSwerve, R_analogPortZionFrontLeftEncoder);
+SwerveModule rearLeftModule(R_CANIDZionRearLeftDrive, R_CANIDZionRearLeftSwerve, R_analogPortZionRearLeftEncoder);
+SwerveModule rearRightModule(R_CANIDZionRearRightDrive, R_CANIDZionRearRightSwerve, R_analogPortZionRearRightEncoder);
 SwerveTrain zion(frontRightModule, frontLeftModule, rearLeftModule, rearRightModule, navX);
 
 Hal Hal9000(intake, launcher, limelight, navX, zion);
 
+Scheduler scheduler;
+
 void Robot::RobotInit() {
 
-    playerOne = new frc::Joystick(R_controllerPortPlayerOne);
-    playerTwo = new frc::XboxController(R_controllerPortPlayerTwo);
+    //The second controller works in control layers on top of the basic
+    //driving mode engaged with function buttons. If one of the functions
+    //running under a button loses its button press, it will be overriden
+    //by the regular mode. Useful for cancellation. Layers override each
+    //other by priority, each only for what it claims; whatever no layer
+    //claims is stopped, with the climber locked.
+    const unsigned claimClimber = m_layersPlayerTwo.getClaim(kClimberLock) | m_layersPlayerTwo.getClaim(kClimberClimb) | m_layersPlayerTwo.getClaim(kClimberTranslate) | m_layersPlayerTwo.getClaim(kClimberWheel);
+    const unsigned claimShooting = m_layersPlayerTwo.getClaim(kIntake) | m_layersPlayerTwo.getClaim(kLauncherIndex) | m_layersPlayerTwo.getClaim(kLauncherLaunch);
+    m_layersPlayerTwo.setDefault(kClimberLock, 1);
+
+    //The back button is "manual override" control layer. No auto, simply
+    //writes unupdated values directly to motors, unlocking the climber,
+    //with no execution caps or impediments. Overrides all other layers.
+    m_layersPlayerTwo.addLayer("Manual", 3, claimClimber | claimShooting, [](const ControllerState &controller) {
+
+        return controller.getButton(ControllerState::kXboxBack);
+    }, [](const ControllerState &controller, auto &frame) {
+
+        const double triggers = -controller.getAxis(ControllerState::kXboxLeftTrigger) + controller.getAxis(ControllerState::kXboxRightTrigger);
+        frame.set(kClimberLock, 0);
+        frame.set(kClimberClimb, triggers);
+        frame.set(kClimberTranslate, controller.getAxis(ControllerState::kXboxLeftX));
+        frame.set(kClimberWheel, controller.getAxis(ControllerState::kXboxRightX));
+        frame.set(kIntake, triggers);
+        frame.set(kLauncherIndex, -controller.getAxis(ControllerState::kXboxLeftY));
+        frame.set(kLauncherLaunch, -controller.getAxis(ControllerState::kXboxRightY));
+    });
+    //The start button is "climber" control layer. Controls nothing but the
+    //climber, holding the rest still. Overrides the auto layer.
+    m_layersPlayerTwo.addLayer("Climber", 2, claimClimber | claimShooting, [](const ControllerState &controller) {
+
+        return controller.getButton(ControllerState::kXboxStart);
+    }, [](const ControllerState &controller, auto &frame) {
+
+        frame.set(kClimberLock, !controller.getButton(ControllerState::kXboxBumperRight));
+        frame.set(kClimberClimb, -controller.getAxis(ControllerState::kXboxLeftTrigger) + controller.getAxis(ControllerState::kXboxRightTrigger));
+        frame.set(kClimberTranslate, controller.getAxis(ControllerState::kXboxLeftX));
+        frame.set(kClimberWheel, controller.getAxis(ControllerState::kXboxRightX));
+    });
+    //The center button is the "auto" control layer. Enables auto functions.
+    //Overrides regular driving, but is overriden by all other layers. None
+    //are assisted yet, so for now it only holds the shooting mechanisms
+    //still.
+    m_layersPlayerTwo.addLayer("Auto", 1, claimShooting, [](const ControllerState &controller) {
+
+        return controller.getButton(9);
+    }, [](const ControllerState &controller, auto &frame) {});
+    //If no layers were engaged, regular driving can begin.
+    m_layersPlayerTwo.addLayer("Regular", 0, claimShooting, [](const ControllerState &controller) {
+
+        return true;
+    }, [](const ControllerState &controller, auto &frame) {
 
-    m_booleanClimberLock = true;
-    m_speedClimberClimb     = 0;
-    m_speedClimberTranslate = 0;
-    m_speedClimberWheel     = 0;
-    m_speedIntake           = 0;
-    m_speedLauncherIndex    = 0;
-    m_speedLauncherLaunch   = 0;
+        frame.set(kIntake, (-controller.getAxis(ControllerState::kXboxLeftTrigger) + controller.getAxis(ControllerState::kXboxRightTrigger)) * R_executionCapIntake);
+        if (controller.getButton(ControllerState::kXboxA)) {
+
+            frame.set(kLauncherIndex, frc::SmartDashboard::GetNumber("Field::Launcher::Speed-Index:", R_launcherDefaultSpeedIndex));
+        }
+        //Far wins if both are held.
+        if (controller.getButton(ControllerState::kXboxB)) {
+
+            frame.set(kLauncherLaunch, frc::SmartDashboard::GetNumber("Field::Launcher::Speed-Launch-Far:", R_launcherDefaultSpeedLaunchFar));
+        }
+        else if (controller.getButton(ControllerState::kXboxX)) {
+
+            frame.set(kLauncherLaunch, frc::SmartDashboard::GetNumber("Field::Launcher::Speed-Launch-Close:", R_launcherDefaultSpeedLaunchClose));
+        }
+    });
 
     m_autoStep = 0;
 
@@ -58,25 +119,61 @@ void Robot::RobotInit() {
     frc::SmartDashboard::PutNumber("Field::Launcher::Speed-Index:", R_launcherDefaultSpeedIndex);
     frc::SmartDashboard::PutNumber("Field::Launcher::Speed-Launch-Close", R_launcherDefaultSpeedLaunchClose);
     frc::SmartDashboard::PutNumber("Field::Launcher::Speed-Launch-Far", R_launcherDefaultSpeedLaunchFar);
+
+    //Find straight from the absolute encoders, where there are any.
+    zion.loadZeroPosition();
+
+    //The modes and mechanisms run in this loop, but steering runs faster,
+    //on its own core, and telemetry slower, so that neither holds up the
+    //other. See Scheduler.h. The drivetrain is driven from its own task too,
+    //by whatever the modes submit to it (see SwerveTrain.h), which also
+    //hands what the swerves are doing to telemetry.
+    scheduler.addLoop("Robot", R_robotLoopPeriod);
+    scheduler.addTask("Steering", [] {zion.updateSteering();}, R_schedulerSteeringPeriod, true);
+    scheduler.addTask("Drive", [] {
+
+        zion.updateCommands();
+        zion.updateState();
+    }, R_schedulerDrivePeriod, true);
+    scheduler.addTask("Telemetry", [] {
+
+        zion.publishSwervePositions();
+        frc::SmartDashboard::PutNumber("NavX::Bias", navX.getBias());
+        controllers.publish();
+        scheduler.publish();
+    }, R_schedulerTelemetryPeriod);
+    scheduler.start();
 }
 void Robot::RobotPeriodic() {
 
     //Whenever Zion is on, allow control of the Limelight from P2. This permits
     //using it for manual alignment at any time, before or after the match.
-    limelight.setLime(playerTwo->GetBumper(frc::GenericHID::kLeftHand));
-    limelight.setProcessing(playerTwo->GetBumper(frc::GenericHID::kRightHand));
+    limelight.setLime(controllers.getPlayerTwo().getButton(ControllerState::kXboxBumperLeft));
+    limelight.setProcessing(controllers.getPlayerTwo().getButton(ControllerState::kXboxBumperRight));
+
+    //Whenever Zion is still, in any mode, learn how far the NavX drifts, so
+    //that field oriented driving does not need resetting mid-match.
+    navX.updateBias(zion.getStationary());
+
+    //This is the end of the loop, so count whether it kept up.
+    scheduler.account("Robot");
 }
 void Robot::AutonomousInit() {
 
     //Set the zero position before beginning auto, as it should have been
-    //calibrated before the match. This persists for the match duration unless
+    //calibrated before the match (or saved against the absolute encoders,
+    //which are read again here). This persists for the match duration unless
     //overriden.
-    zion.setZeroPosition();
+    zion.loadZeroPosition();
     //Get which auto was selected to run in auto to test against.
     m_chooserAutoSelected = m_chooserAuto->GetSelected();
 }
 void Robot::AutonomousPeriodic() {
 
+    //Every loop runs one of the modes, then RobotPeriodic(), so this is
+    //the start of it: read the controllers once for everything after.
+    controllers.update();
+
     //Lock the drive wheels before beginning for accuracy.
     zion.setDriveBrake(true);
 
@@ -107,11 +204,11 @@ void Robot::AutonomousPeriodic() {
         //Spin up launcher, feed it cells, turn it off, and drive off the line.
         if (m_autoStep == 0) {
 
-            Wait(frc::SmartDashboard::GetNumber("Field::Auto::3Cell-Delay", 0));
+            frc::Wait(frc::SmartDashboard::GetNumber("Field::Auto::3Cell-Delay", 0));
             launcher.setLaunchSpeed(R_launcherDefaultSpeedLaunchClose);
-            Wait(1);
+            frc::Wait(1);
             launcher.setIndexSpeed(R_launcherDefaultSpeedIndex);
-            Wait(5);
+            frc::Wait(5);
             launcher.setLaunchSpeed(0);
             launcher.setIndexSpeed(0);
             m_autoStep = 1;
@@ -130,122 +227,66 @@ void Robot::TeleopInit() {
 
     //To clean up adter auto, confirm the swerves are locked and unlock
     //the drive train, and go to the pre-calibrated zero position set up at the
-    //beginning of auto to begin the match.
+    //beginning of auto to begin the match (which the drive task does; see
+    //SwerveTrain.h).
     zion.setSwerveBrake(true);
     zion.setDriveBrake(false);
-    zion.assumeNearestZeroPosition();
+    zion.submit(DriveCommand::fromAction(DriveCommand::kTeleop, DriveCommand::kStraighten));
 }
 void Robot::TeleopPeriodic() {
 
-    if (playerOne->GetRawButtonPressed(3)) {
+    controllers.update();
+    const ControllerState &playerOne = controllers.getPlayerOne();
+
+    if (playerOne.getButtonPressed(3)) {
 
         zion.setZeroPosition();
     }
-    if (playerOne->GetRawButton(1)) {
+    if (playerOne.getButton(1)) {
 
         navX.resetYaw();
     }
-    if (playerOne->GetRawButton(12)) {
-
-        zion.driveControllerPrecision(playerOne); 
-    }
-    else {
-
-        zion.driveController(playerOne);
-    }
-
-
-    //The second controller works in control layers on top of the basic
-    //driving mode engaged with function buttons. If one of the functions
-    //running under a button loses its button press, it will be overriden
-    //by the regular mode. Useful for cancellation. Layers override each other.
+    if (playerOne.getButton(12)) {
 
-    //The back button is "manual override" control layer. No auto, simply
-    //writes unupdated values directly to motors, unlocking the climber,
-    //with no execution caps or impediments. Overrides all other layers.
-    if (playerTwo->GetBackButton()) {
-
-        m_booleanClimberLock = false;
-        m_speedClimberClimb = -playerTwo->GetTriggerAxis(frc::GenericHID::kLeftHand) + playerTwo->GetTriggerAxis(frc::GenericHID::kRightHand);
-        m_speedClimberTranslate = playerTwo->GetX(frc::GenericHID::kLeftHand);
-        m_speedClimberWheel = playerTwo->GetX(frc::GenericHID::kRightHand);
-        m_speedIntake = -playerTwo->GetTriggerAxis(frc::GenericHID::kLeftHand) + playerTwo->GetTriggerAxis(frc::GenericHID::kRightHand);
-        m_speedLauncherIndex = -playerTwo->GetY(frc::GenericHID::kLeftHand);
-        m_speedLauncherLaunch = -playerTwo->GetY(frc::GenericHID::kRightHand);
+        zion.driveController(playerOne, {0, 0}, R_executionCapZionPrecision);
     }
-    else {
+    else if (playerOne.getButton(R_pivotButtonFrontLeft)) {
 
-        m_booleanClimberLock = true;
-        m_speedClimberClimb = 0;
-        m_speedClimberTranslate = 0;
-        m_speedClimberWheel = 0;
-        m_speedIntake = 0;
-        m_speedLauncherIndex = 0;
-        m_speedLauncherLaunch = 0;
+        zion.driveController(playerOne, zion.getCenterOfRotation(SwerveTrain::CentersOfRotation::kFrontLeftBumper));
     }
+    else if (playerOne.getButton(R_pivotButtonFrontRight)) {
 
-    //The start button is "climber" control layer. Controls nothing but the
-    //climber. Overrides the auto layer.
-    if (!playerTwo->GetBackButton() && playerTwo->GetStartButton()) {
-
-        m_speedClimberClimb = -playerTwo->GetTriggerAxis(frc::GenericHID::kLeftHand) + playerTwo->GetTriggerAxis(frc::GenericHID::kRightHand);
-        m_speedClimberTranslate = playerTwo->GetX(frc::GenericHID::kLeftHand);
-        m_speedClimberWheel = playerTwo->GetX(frc::GenericHID::kRightHand);
-        m_booleanClimberLock = !playerTwo->GetBumper(frc::GenericHID::kRightHand);
+        zion.driveController(playerOne, zion.getCenterOfRotation(SwerveTrain::CentersOfRotation::kFrontRightBumper));
     }
     else {
 
-        m_speedClimberClimb = 0;
-        m_speedClimberTranslate = 0;
-        m_speedClimberWheel = 0;
-        m_booleanClimberLock = true;
+        zion.driveController(playerOne);
     }
 
-    //The center button is the "auto" control layer. Enables auto functions.
-    //Overrides regular driving, but is overriden by all other layers.
-    if (!playerTwo->GetBackButton() && !playerTwo->GetStartButton() && playerTwo->GetRawButton(9)) {}
-    else {}
-
-    //If no layers were engaged, regular driving can begin.
-    if (!playerTwo->GetBackButton() && !playerTwo->GetStartButton() && !playerTwo->GetRawButton(9)) {
-
-        m_speedIntake = (-playerTwo->GetTriggerAxis(frc::GenericHID::kLeftHand) + playerTwo->GetTriggerAxis(frc::GenericHID::kRightHand)) * R_executionCapIntake;
-
-        if (playerTwo->GetAButton()) {
-
-            m_speedLauncherIndex = frc::SmartDashboard::GetNumber("Field::Launcher::Speed-Index:", R_launcherDefaultSpeedIndex);
-        }
-        else {
-
-            m_speedLauncherIndex = 0;
-        }
-        if (playerTwo->GetXButton()) {
 
-            m_speedLauncherLaunch = frc::SmartDashboard::GetNumber("Field::Launcher::Speed-Launch-Close:", R_launcherDefaultSpeedLaunchClose);
-        }
-        if (playerTwo->GetBButton()) {
+    //P2's layers (see RobotInit) decide who sets what, then write out all
+    //of their values. Doing this only once prevents weird bugs in which
+    //multiple different values get set at different times in the loop.
+    const auto &frame = m_layersPlayerTwo.resolve(controllers.getPlayerTwo());
+    climber.lock(frame.get(kClimberLock) != 0);
+    climber.setSpeed(Climber::Motor::kClimb, frame.get(kClimberClimb));
+    climber.setSpeed(Climber::Motor::kTranslate, frame.get(kClimberTranslate));
+    climber.setSpeed(Climber::Motor::kWheel, frame.get(kClimberWheel));
+    intake.setSpeed(frame.get(kIntake));
+    launcher.setIndexSpeed(frame.get(kLauncherIndex));
+    launcher.setLaunchSpeed(frame.get(kLauncherLaunch));
+}
+void Robot::TestPeriodic() {
 
-            m_speedLauncherLaunch = frc::SmartDashboard::GetNumber("Field::Launcher::Speed-Launch-Far:", R_launcherDefaultSpeedLaunchFar);
-        }
-        if (!playerTwo->GetXButton() && !playerTwo->GetBButton()) {
+    controllers.update();
 
-            m_speedLauncherLaunch = 0;
-        }
-    }
-
-    //Once all layers have been evaluated, write out all of their values.
-    //Doing this only once prevents weird bugs in which multiple different
-    //values get set at different times in the loop.
-    climber.lock(m_booleanClimberLock);
-    climber.setSpeed(Climber::Motor::kClimb, m_speedClimberClimb);
-    climber.setSpeed(Climber::Motor::kTranslate, m_speedClimberTranslate);
-    climber.setSpeed(Climber::Motor::kWheel, m_speedClimberWheel);
-    intake.setSpeed(m_speedIntake);
-    launcher.setIndexSpeed(m_speedLauncherIndex);
-    launcher.setLaunchSpeed(m_speedLauncherLaunch);
+    //Test mode is for calibrating the swerve zeros by hand; see zeroController.
+    zion.zeroController(controllers.getPlayerOne());
 }
 void Robot::DisabledPeriodic() {
 
+    controllers.update();
+
     //Whenever Zion is disabled, if the unlock swerve button is pressed and
     //held, unlock the swerves for zeroing. Once released, lock them again. The
     //switch is inverted by default, so no inversion is required. This is in
@@ -1,16 +1,25 @@
 #include <math.h>
 
+#include "ResponseCurve.h"
 #include "SwerveModule.h"
 
-void SwerveModule::assumeSwervePosition(const double &positionToAssume) {
+#ifdef INCLUDE_FAKE_DEVICES
+#include "FakeDevices.h"
+#endif
+
+template <class Devices>
+void BasicSwerveModule<Devices>::assumeSwervePosition(const double &positionToAssume, const double &positionRate) {
 
     double currentPosition = getSwervePositionSingleRotation();
+    //The output that turns the swerve as fast as the position is moving, so
+    //that the speed curve only has to close the distance.
+    const double feedforward = positionRate * 60 / R_NEOFreeSpeed;
 
     //If the current position is close enough to where we want to go (within one tolerance value)...
     if (abs(positionToAssume - currentPosition) < R_swerveTrainAssumePositionTolerance) {
 
-        //Stop rotating the swerve motor and skip checking anything else...
-        m_swerveMotor->Set(0);
+        //Only keep up with the position and skip checking anything else...
+        m_swerveMotor->Set(feedforward);
     }
     //If the position to assume is greater than half a revolution in the clockwise direction...
     else if (abs(positionToAssume - currentPosition) > R_nicsConstant / 2) {
@@ -19,35 +28,58 @@ void SwerveModule::assumeSwervePosition(const double &positionToAssume) {
         if (positionToAssume < currentPosition) {
 
             //Set the speed of the motor using the Nic's Constant distance between the two points...
-            m_swerveMotor->Set(calculateAssumePositionSpeed(R_nicsConstant - (currentPosition - positionToAssume)));
+            m_swerveMotor->Set(calculateAssumePositionSpeed(R_nicsConstant - (currentPosition - positionToAssume)) + feedforward);
         }
         //If such a rotation needs to be counterclockwise...
         else if (positionToAssume > currentPosition) {
 
             //Set the speed similarly, but negatively...
-            m_swerveMotor->Set(calculateAssumePositionSpeed(-R_nicsConstant + (positionToAssume - currentPosition)));
+            m_swerveMotor->Set(calculateAssumePositionSpeed(-R_nicsConstant + (positionToAssume - currentPosition)) + feedforward);
         }
     }
     else {
 
         //Otherwise, perform a normal between two points rotation with a Nic's Constant value.
-        m_swerveMotor->Set(calculateAssumePositionSpeed(positionToAssume - currentPosition));
+        m_swerveMotor->Set(calculateAssumePositionSpeed(positionToAssume - currentPosition) + feedforward);
     }
 }
 
-double SwerveModule::calculateAssumePositionSpeed(const double &howFarRemainingInTravel) {
+//The part of the speed curve that is not an end behavior, which is the
+//expensive part, since it calls exp()...
+static constexpr double assumePositionSpeedSigmoid(const double &howFarRemainingInTravel) {
+
+    return ((1) / (1 + constexprExp((-1 * howFarRemainingInTravel) + 5)));
+}
+//Is worked out ahead of time over every distance the optimal path can ask
+//for, which is up to half a rotation. See ResponseCurve.h.
+static constexpr ResponseCurve<R_swerveTrainAssumePositionSpeedCalculationTableSize> assumePositionSpeedCurve(assumePositionSpeedSigmoid, 0, R_nicsConstant / 2);
+static_assert(assumePositionSpeedCurve.getMaxError(assumePositionSpeedSigmoid) < R_swerveTrainAssumePositionSpeedCalculationTableMaxError, "The swerve speed table is too coarse for its curve; raise R_swerveTrainAssumePositionSpeedCalculationTableSize.");
+
+template <class Devices>
+double BasicSwerveModule<Devices>::calculateAssumePositionSpeed(const double &howFarRemainingInTravel) {
+
+    const double distance = fabs(howFarRemainingInTravel);
+    double toReturn = 0;
+    //If we satisfy conditions for the second linear piecewise, take that speed...
+    if (distance < R_swerveTrainAssumePositionSpeedCalculationSecondEndBehaviorAt) {
 
-    //Begin initally with a double calculated with the simplex function...
-    double toReturn = ((1) / (1 + exp((-1 * abs(howFarRemainingInTravel)) + 5)));
-    //If we satisfy conditions for the first linear piecewise, take that speed instead...
-    if (abs(howFarRemainingInTravel) < R_swerveTrainAssumePositionSpeedCalculationFirstEndBehaviorAt) {
+        toReturn = R_swerveTrainAssumePositionSpeedCalculationSecondEndBehaviorSpeed;
+    }
+    //Or do the same for the first...
+    else if (distance < R_swerveTrainAssumePositionSpeedCalculationFirstEndBehaviorAt) {
 
         toReturn = R_swerveTrainAssumePositionSpeedCalculationFirstEndBehaviorSpeed;
     }
-    //Do the same for the second...
-    if (abs(howFarRemainingInTravel) < R_swerveTrainAssumePositionSpeedCalculationSecondEndBehaviorAt) {
+    //Otherwise read the sigmoid function from its table...
+    else if (assumePositionSpeedCurve.contains(distance)) {
 
-        toReturn = R_swerveTrainAssumePositionSpeedCalculationSecondEndBehaviorSpeed;
+        toReturn = assumePositionSpeedCurve.getValue(distance);
+    }
+    //Unless a position past half a rotation was asked for, which is rare
+    //enough to calculate outright...
+    else {
+
+        toReturn = ((1) / (1 + exp((-1 * distance) + 5)));
     }
     //And if we needed to travel negatively to get where we need to be, make the final speed negative...
     if (howFarRemainingInTravel < 0) {
@@ -56,3 +88,9 @@ double SwerveModule::calculateAssumePositionSpeed(const double &howFarRemainingI
     }
     return toReturn;
 }
+
+template class BasicSwerveModule<RevDevices>;
+//The fakes are only built into the tests (see FakeDevices.h).
+#ifdef INCLUDE_FAKE_DEVICES
+template class BasicSwerveModule<FakeDevices>;
+#endif
@@ -1,29 +1,159 @@
 #include <math.h>
 
-#include <frc/Joystick.h>
-
+#include "Angle.h"
+#include "Controllers.h"
+#include "DriveInput.h"
 #include "SwerveTrain.h"
-#include "VectorDouble.h"
+#include "Vec2.h"
 #include "Launcher.h"
 #include "Limelight.h"
 
-void SwerveTrain::driveController(frc::Joystick *controller) {
+#ifdef INCLUDE_FAKE_DEVICES
+#include "FakeDevices.h"
+#endif
+
+//The unit vector pointing at each wheel's RELATIVE yaw (the position we put
+//the wheels in so that it can turn, with zero at the top). The wheels never
+//move relative to the center, so these are only worked out once.
+static const Vec2d wheelDirections[4] = {
+
+    {cos(R_angleFromCenterToFrontRightWheel * (M_PI / 180)), sin(R_angleFromCenterToFrontRightWheel * (M_PI / 180))},
+    {cos(R_angleFromCenterToFrontLeftWheel * (M_PI / 180)), sin(R_angleFromCenterToFrontLeftWheel * (M_PI / 180))},
+    {cos(R_angleFromCenterToRearLeftWheel * (M_PI / 180)), sin(R_angleFromCenterToRearLeftWheel * (M_PI / 180))},
+    {cos(R_angleFromCenterToRearRightWheel * (M_PI / 180)), sin(R_angleFromCenterToRearRightWheel * (M_PI / 180))}
+};
+
+template <class Devices>
+void BasicSwerveTrain<Devices>::updateCommands() {
+
+    //A command only stands for as long as its source keeps sending it, so
+    //anything that stops (a mode ending, a hung loop) stops Zion too. Stop
+    //once, and the swerves stay stopped until the next command.
+    const double now = DriveCommand::now();
+    if (m_commandHeld && now - m_command.timestamp > R_driveCommandTimeout) {
+
+        setDriveSpeed(0);
+        setSwerveSpeed(0);
+        m_commandHeld = false;
+    }
+
+    //Of everything sent since, the highest priority wins, and the newest of
+    //those, since the queue is in the order they were sent. A lower one
+    //waits until the higher has stopped standing.
+    DriveCommand command;
+    while (m_commands.pop(command)) {
+
+        //Calibrations are not driving, so they are simply carried out, in
+        //the order they were sent.
+        if (calibrate(command.action)) {
+
+            continue;
+        }
+        if (now - command.timestamp <= R_driveCommandTimeout && (!m_commandHeld || command.priority >= m_command.priority)) {
+
+            m_command = command;
+            m_commandHeld = true;
+        }
+    }
+    if (!m_commandHeld) {
+
+        return;
+    }
+    if (m_command.action == DriveCommand::kStop) {
+
+        setDriveSpeed(0);
+        setSwerveSpeed(0);
+        m_commandHeld = false;
+        return;
+    }
+    //Nudging a swerve by hand stands for as long as it is sent, standing
+    //still...
+    if (m_command.action == DriveCommand::kNudge) {
 
-    //TODO: Why does inverting certain things work?
-    double x = -controller->GetX();
-    double y = -controller->GetY();
-    //Limit the Z axis by the cap, as turning can be violent
-    double z = controller->GetZ() * R_executionCapZion;
+        setDriveSpeed(0);
+        setSwerveSpeeds(m_command.swerveSpeeds);
+        return;
+    }
+    //As does pointing, since the swerves take a few loops to get there.
+    if (m_command.action == DriveCommand::kPoint || m_command.action == DriveCommand::kStraighten) {
 
-    //TODO: What is this?
-    double angle = navX->getYawFull();
+        pointModules(m_command.action == DriveCommand::kPoint ? m_command.speeds : ChassisSpeeds{0, 0, 0});
+        return;
+    }
+    drive(m_command.speeds, m_command.fieldRelative, m_command.centerOfRotation);
 
-    //To prevent controller drift, if the values of X, Y, and Z are inside of
-    //deadzone, set them to 0.
-    forceControllerXYZToZeroInDeadzone(x, y, z);
+    //A command to stop is done with once Zion has.
+    if (m_command.speeds.isZero() && m_setpoint.isZero()) {
+
+        m_commandHeld = false;
+    }
+}
+template <class Devices>
+void BasicSwerveTrain<Devices>::drive(const ChassisSpeeds &speeds, const bool &fieldRelative, const Vec2d &centerOfRotation) {
+
+    //Before pointing anything, check that the modules still know where they
+    //point.
+    updateSteeringDrift();
+
+    //Work relative to the robot from here on, since that is how the modules
+    //see it. Relative to the field, forward is turned by the yaw...
+    ChassisSpeeds robotSpeeds = speeds;
+    if (fieldRelative) {
+
+        const double angle = navX->getYawFull() * (M_PI / 180);
+        const Vec2d translation = Vec2d{speeds.vx, speeds.vy}.rotate(cos(angle), sin(angle));
+        robotSpeeds = {translation.i, translation.j, speeds.omega};
+    }
 
-    //To prevent accidental turning, optimize Z to X and Y's magnitude.
-    optimizeControllerXYToZ(x, y, z);
+    //Then only go as far toward the speeds as the modules can follow in one
+    //loop. Stopping is limited too, so the robot slows rather than skids.
+    m_setpoint = limitSetpoint(robotSpeeds, centerOfRotation);
+
+    //If nothing should move, stop everything where it is, since there is no
+    //direction to point the swerves in.
+    if (m_setpoint.isZero()) {
+
+        setDriveSpeed(0);
+        setSwerveSpeed(0);
+        return;
+    }
+
+    double x;
+    double y;
+    double z;
+    getKinematicInputs(m_setpoint, x, y, z);
+    driveModules(x, y, z, 0, centerOfRotation);
+}
+template <class Devices>
+void BasicSwerveTrain<Devices>::driveController(const ControllerState &controller, const Vec2d &centerOfRotation, const double &executionCap) {
+
+    //If the controller is in the total deadzone (entirely still) and Zion
+    //is set to straighten out when idle...
+    if (DriveInput::getInDeadzone(controller) && R_zionIdleAssumeZeroPosition) {
+
+        //Stop dead and go to the nearest zero position. That turns the
+        //swerves, so like driving it is left to the thread that owns them...
+        m_driverInput.reset();
+        submit(DriveCommand::fromAction(DriveCommand::kTeleop, DriveCommand::kStraighten));
+    }
+    //Otherwise, if it is still, slow to a stop and leave the swerves
+    //pointing where they last were, so that picking back up in the same
+    //direction drives immediately rather than turning back first. The
+    //setpoint generator already slows Zion down, so the stick starts again
+    //from zero...
+    else if (DriveInput::getInDeadzone(controller)) {
+
+        m_driverInput.reset();
+        submit(DriveCommand::fromSource(DriveCommand::kTeleop, {0, 0, 0}));
+    }
+    //Otherwise, drive at whatever the controller asks for.
+    else {
+
+        submit(DriveCommand::fromSource(DriveCommand::kTeleop, m_driverInput.getChassisSpeeds(controller, executionCap, R_executionCapZionRotation), true, centerOfRotation));
+    }
+}
+template <class Devices>
+void BasicSwerveTrain<Devices>::calculateModuleTargets(const double &x, const double &y, const double &z, const double &angle, double positions[4], double speeds[4], const double &headingRate, const double &period, double positionRates[4], const Vec2d &centerOfRotation) {
 
     /*
     The translation vector is the "standard" vector - that is, if no rotation
@@ -34,257 +164,438 @@ void SwerveTrain::driveController(frc::Joystick *controller) {
     away from the operator, and simply driving "straight" at a 45* angle
     would make it drive away from the operator at 45*. This is true of any
     angle, so the gyro is needed to offset the vector described by X and Y.
-    VectorDouble translationVector(0, 0);
     */
     //TODO: why inverted?
-    VectorDouble translationVector(-x, y);
+    Vec2d translationVector{-x, y};
 
     /*
-    The rotational vectors are found by multiplying the controller's
-    rotational axis [-1, 1] by the cosine of the wheel's RELATIVE yaw (the
-    position we put the wheels in so that it can turn, with zero at the top)
-    minus the number of degrees we are offset from 0.  Then, for the j value
-    we do the same, except we use sine, for Y.  All angles passed as paramaters
-    to cos() and sin() are converted to radians first.
+    If the robot is turning, the modules hold their direction relative to it
+    for the whole period while it turns underneath them, so it would travel
+    an arc instead of a line. To end the period where the line would have
+    taken it, aim the translation at the heading halfway through the turn,
+    and lengthen it from the arc's chord to its length. The heading rate is
+    counted counterclockwise, as the upside-down NavX counts it (see
+    getHeadingRate()), and the vector is turned the same way.
     */
-    VectorDouble frontRightRotationVector (
-
-        z * cos((R_angleFromCenterToFrontRightWheel - angle) * (M_PI / 180)),
-        z * sin((R_angleFromCenterToFrontRightWheel - angle) * (M_PI / 180))
-    );
-
-    VectorDouble frontLeftRotationVector (
-
-        z * cos((R_angleFromCenterToFrontLeftWheel - angle) * (M_PI / 180)),
-        z * sin((R_angleFromCenterToFrontLeftWheel - angle) * (M_PI / 180))
-    );
+    const double headingChange = headingRate * period * (M_PI / 180);
+    if (headingChange != 0) {
 
-    VectorDouble rearLeftRotationVector (
-
-        z * cos((R_angleFromCenterToRearLeftWheel - angle) * (M_PI / 180)),
-        z * sin((R_angleFromCenterToRearLeftWheel - angle) * (M_PI / 180))
-    );
-
-    VectorDouble rearRightRotationVector (
+        translationVector = translationVector.rotate(cos(headingChange / 2), sin(headingChange / 2)) * ((headingChange / 2) / sin(headingChange / 2));
+    }
 
-        z * cos((R_angleFromCenterToRearRightWheel - angle) * (M_PI / 180)),
-        z * sin((R_angleFromCenterToRearRightWheel - angle) * (M_PI / 180))
-    );
+    /*
+    The rotational vectors are found by multiplying the controller's
+    rotational axis [-1, 1] by the unit vector pointing at the wheel's
+    RELATIVE yaw (see wheelDirections) turned back by the number of degrees
+    we are offset from 0. The offset is one cosine and one sine shared by all
+    four rather than a pair for each wheel.
+    */
+    const double cosineAngle = cos(-angle * (M_PI / 180));
+    const double sineAngle = sin(-angle * (M_PI / 180));
 
     /*
-    And the vector we actually want to apply to the swerves is the sum of
-    the two vectors - the vector that forms "straight" (translationVector)
-    and the vector that forms strictly the rotation (rotationVector).
+    Each wheel's rotational vector is its direction from the center with X
+    and Y swapped (a quarter turn, mirrored like the rest of Zion), scaled so
+    the wheels are one long. Swapping is linear, so turning about some other
+    point moves every wheel's vector by the same amount: that point, swapped,
+    over the module radius. A wheel further from it is longer, and drives
+    faster, than one closer. This is all on the stack, once per call.
     */
-    VectorDouble frontRightResultVector = translationVector + frontRightRotationVector;
-    VectorDouble frontLeftResultVector = translationVector + frontLeftRotationVector;
-    VectorDouble rearLeftResultVector = translationVector + rearLeftRotationVector;
-    VectorDouble rearRightResultVector = translationVector + rearRightRotationVector;
+    const Vec2d centerOffset = Vec2d{centerOfRotation.j, centerOfRotation.i} / R_zionModuleRadius;
 
-    //If the controller is in the total deadzone (entirely still)...
-    if (getControllerInDeadzone(controller)) {
+    BasicSwerveModule<Devices> *modules[4] = {m_frontRight, m_frontLeft, m_rearLeft, m_rearRight};
+    for (int module = 0; module < 4; module++) {
 
         /*
-        Go to the nearest zero position, take it as the new zero, and
-        reset the angle coming off of the gyroscope to zero to allow
-        setting of the next translation vector, as the translation
-        vector is always refereced from "center" (the beginning of the
-        turn) and updated based on how much that gyro angle changes.
-        Due to this, it must be reset when not in movement to allow
-        this behavior to occur...
+        And the vector we actually want to apply to the swerves is the sum of
+        the two vectors - the vector that forms "straight" (translationVector)
+        and the vector that forms strictly the rotation.
         */
-        setDriveSpeed(0);
-        assumeNearestZeroPosition();
-    }
-    //Otherwise, go to the result vectors and use the magnitude to set the
-    //speed of driving, and set each wheel's swerve position based on its
-    //respective resulting vector.
-    else {
+        const Vec2d resultVector = translationVector + (wheelDirections[module] - centerOffset).rotate(cosineAngle, sineAngle) * z;
 
         /*
-        Here, all of the resulting vectors are
-        converted into Nics so that they can be written to the swerve modules
-        using assumeSwervePosition(). They were in degrees before to enable the
-        use of common trigonomoetry. We get Nics from degrees by calling
-        getSwerveRotatingPosition().
+        Here, the resulting vector is converted into Nics so that it can be
+        written to the swerve module using assumeSwervePosition(), and its
+        length is the speed.
         */
-        m_frontRight->assumeSwervePosition(m_frontRight->getStandardDegreeSwervePosition(frontRightResultVector, angle));
-        m_frontLeft->assumeSwervePosition(m_frontLeft->getStandardDegreeSwervePosition(frontLeftResultVector, angle));
-        m_rearLeft->assumeSwervePosition(m_rearLeft->getStandardDegreeSwervePosition(rearLeftResultVector, angle));
-        m_rearRight->assumeSwervePosition(m_rearRight->getStandardDegreeSwervePosition(rearRightResultVector, angle));
+        positions[module] = modules[module]->getStandardDegreeSwervePosition(resultVector, angle);
+        speeds[module] = resultVector.norm();
 
-        m_frontRight->setDriveSpeed(frontRightResultVector.magnitude() * R_executionCapZion);
-        m_frontLeft->setDriveSpeed(frontLeftResultVector.magnitude() * R_executionCapZion);
-        m_rearLeft->setDriveSpeed(rearLeftResultVector.magnitude() * R_executionCapZion);
-        m_rearRight->setDriveSpeed(rearRightResultVector.magnitude() * R_executionCapZion);
+        /*
+        As the robot turns, the translation turns against it while the
+        rotation stays put, so the position itself moves. How fast is the
+        heading rate times the part of the resulting vector that is along the
+        translation, over its length squared (the derivative of its angle).
+        */
+        if (positionRates) {
+
+            const double lengthSquared = resultVector.normSquared();
+            positionRates[module] = lengthSquared == 0 ? 0 : (headingRate / 360.) * R_nicsConstant * resultVector.dot(translationVector) / lengthSquared;
+        }
     }
 }
-void SwerveTrain::driveControllerPrecision(frc::Joystick *controller) {
 
-    double x = -controller->GetX();
-    double y = -controller->GetY();
-    double z = controller->GetZ();
-
-    double angle = navX->getYawFull();
+template <class Devices>
+void BasicSwerveTrain<Devices>::driveModules(const double &x, const double &y, const double &z, const double &angle, const Vec2d &centerOfRotation) {
+
+    double positions[4];
+    double speeds[4];
+    double positionRates[4];
+
+    //The robot turns while these are held for the loop, so first find out
+    //how fast. That takes the speeds, since desaturation below slows the
+    //turn as much as anything...
+    calculateModuleTargets(x, y, z, angle, positions, speeds, 0, 0, nullptr, centerOfRotation);
+    const double headingRate = getHeadingRate(z, speeds);
+    //And then the targets that account for it.
+    calculateModuleTargets(x, y, z, angle, positions, speeds, headingRate, R_robotLoopPeriod, positionRates, centerOfRotation);
+
+    //The steering thread steers toward them until the next loop (see
+    //updateSteering()).
+    SteeringTargets targets{};
+    targets.steer = true;
+    for (int module = 0; module < 4; module++) {
+
+        targets.positions[module] = positions[module];
+        targets.rates[module] = positionRates[module];
+    }
+    writeSteeringTargets(targets);
 
-    forceControllerXYZToZeroInDeadzone(x, y, z);
+    //Translation and rotation together can ask a module for more than full
+    //speed. Rather than letting that one clamp (and the robot arc), slow all
+    //of them together, in meters per second...
+    for (int module = 0; module < 4; module++) {
 
-    optimizeControllerXYToZ(x, y, z);
+        speeds[module] *= R_zionDriveMaxVelocity;
+    }
+    desaturateModuleSpeeds(speeds, R_zionMaxModuleSpeed);
 
-    VectorDouble translationVector(-x, y);
+    //A module still turning toward its position would push partly the wrong
+    //way, so only drive the part of its speed along where it points now.
+    //Past a quarter turn off, that would be backwards, so it waits.
+    BasicSwerveModule<Devices> *modules[4] = {m_frontRight, m_frontLeft, m_rearLeft, m_rearRight};
+    for (int module = 0; module < 4; module++) {
 
-    VectorDouble frontRightRotationVector (
+        const double error = remainder(positions[module] - modules[module]->getSwervePositionSingleRotation(), R_nicsConstant) * (2 * M_PI / R_nicsConstant);
+        speeds[module] *= fmax(cos(error), 0);
+    }
 
-        z * cos((R_angleFromCenterToFrontRightWheel - angle) * (M_PI / 180)),
-        z * sin((R_angleFromCenterToFrontRightWheel - angle) * (M_PI / 180))
-    );
+    //And hand them back to the modules as fractions of full speed.
+    m_frontRight->setDriveSpeed(speeds[0] / R_zionDriveMaxVelocity);
+    m_frontLeft->setDriveSpeed(speeds[1] / R_zionDriveMaxVelocity);
+    m_rearLeft->setDriveSpeed(speeds[2] / R_zionDriveMaxVelocity);
+    m_rearRight->setDriveSpeed(speeds[3] / R_zionDriveMaxVelocity);
+}
+template <class Devices>
+void BasicSwerveTrain<Devices>::pointModules(const ChassisSpeeds &speeds) {
+
+    //Pointing is done standing still...
+    setDriveSpeed(0);
+
+    //And the way to point is the way the speeds would translate the robot,
+    //as drive() would find it, or straight (zero) if they would not.
+    double position = 0;
+    if (speeds.vx != 0 || speeds.vy != 0) {
+
+        double x;
+        double y;
+        double z;
+        getKinematicInputs(speeds, x, y, z);
+        position = m_frontRight->getStandardDegreeSwervePosition({-x, y}, 0);
+    }
 
-    VectorDouble frontLeftRotationVector (
+    SteeringTargets targets{};
+    targets.steer = true;
+    bool pointed = true;
+    BasicSwerveModule<Devices> *modules[4] = {m_frontRight, m_frontLeft, m_rearLeft, m_rearRight};
+    for (int module = 0; module < 4; module++) {
 
-        z * cos((R_angleFromCenterToFrontLeftWheel - angle) * (M_PI / 180)),
-        z * sin((R_angleFromCenterToFrontLeftWheel - angle) * (M_PI / 180))
-    );
+        targets.positions[module] = position;
+        targets.rates[module] = 0;
+        pointed = pointed && fabs(remainder(position - modules[module]->getSwervePositionSingleRotation(), R_nicsConstant)) < R_swerveTrainAssumePositionTolerance;
+    }
+    //The steering thread steers there, in place of wherever drive() last
+    //aimed (see updateSteering())...
+    writeSteeringTargets(targets);
+    //And let whoever asked know once they are there.
+    if (pointed) {
 
-    VectorDouble rearLeftRotationVector (
+        m_pointedTimestamp = m_command.timestamp;
+    }
+}
+template <class Devices>
+bool BasicSwerveTrain<Devices>::calibrate(const int &action) {
 
-        z * cos((R_angleFromCenterToRearLeftWheel - angle) * (M_PI / 180)),
-        z * sin((R_angleFromCenterToRearLeftWheel - angle) * (M_PI / 180))
-    );
+    BasicSwerveModule<Devices> *modules[4] = {m_frontRight, m_frontLeft, m_rearLeft, m_rearRight};
+    for (int module = 0; module < 4; module++) {
 
-    VectorDouble rearRightRotationVector (
+        switch (action) {
 
-        z * cos((R_angleFromCenterToRearRightWheel - angle) * (M_PI / 180)),
-        z * sin((R_angleFromCenterToRearRightWheel - angle) * (M_PI / 180))
-    );
+            case DriveCommand::kSetZeroPosition: modules[module]->setZeroPosition(); break;
+            case DriveCommand::kLoadZeroPosition: modules[module]->loadZeroPosition(); break;
+            case DriveCommand::kSaveZeroPosition: modules[module]->saveZeroPosition(); break;
+            default: return false;
+        }
+    }
+    return true;
+}
+template <class Devices>
+ChassisSpeeds BasicSwerveTrain<Devices>::limitSetpoint(const ChassisSpeeds &speeds, const Vec2d &centerOfRotation) {
 
-    VectorDouble frontRightResultVector = translationVector + frontRightRotationVector;
-    VectorDouble frontLeftResultVector = translationVector + frontLeftRotationVector;
-    VectorDouble rearLeftResultVector = translationVector + rearLeftRotationVector;
-    VectorDouble rearRightResultVector = translationVector + rearRightRotationVector;
+    //Where the modules were sent last loop...
+    double lastPositions[4];
+    double lastSpeeds[4];
+    getModuleSetpoints(m_setpoint, centerOfRotation, lastPositions, lastSpeeds);
 
-    if (getControllerInDeadzone(controller)) {
+    //Usually the new speeds are close enough to go straight to...
+    if (getSetpointReachable(speeds, centerOfRotation, lastPositions, lastSpeeds)) {
 
-        setDriveSpeed(0);
-        setSwerveSpeed(0);
+        return speeds;
     }
-    else {
+    //And if not, halve the way there until the furthest reachable fraction
+    //is known closely enough. This is all on the stack.
+    double reachable = 0;
+    double unreachable = 1;
+    for (int iteration = 0; iteration < R_zionSetpointIterations; iteration++) {
+
+        const double fraction = (reachable + unreachable) / 2;
+        if (getSetpointReachable(m_setpoint.interpolate(speeds, fraction), centerOfRotation, lastPositions, lastSpeeds)) {
 
-        m_frontRight->assumeSwervePosition(m_frontRight->getStandardDegreeSwervePosition(frontRightResultVector, angle));
-        m_frontLeft->assumeSwervePosition(m_frontLeft->getStandardDegreeSwervePosition(frontLeftResultVector, angle));
-        m_rearLeft->assumeSwervePosition(m_rearLeft->getStandardDegreeSwervePosition(rearLeftResultVector, angle));
-        m_rearRight->assumeSwervePosition(m_rearRight->getStandardDegreeSwervePosition(rearRightResultVector, angle));
+            reachable = fraction;
+        }
+        else {
 
-        m_frontRight->setDriveSpeed(frontRightResultVector.magnitude() * R_executionCapZionPrecision);
-        m_frontLeft->setDriveSpeed(frontLeftResultVector.magnitude() * R_executionCapZionPrecision);
-        m_rearLeft->setDriveSpeed(rearLeftResultVector.magnitude() * R_executionCapZionPrecision);
-        m_rearRight->setDriveSpeed(rearRightResultVector.magnitude() * R_executionCapZionPrecision);
+            unreachable = fraction;
+        }
     }
+    return m_setpoint.interpolate(speeds, reachable);
 }
+template <class Devices>
+bool BasicSwerveTrain<Devices>::getSetpointReachable(const ChassisSpeeds &speeds, const Vec2d &centerOfRotation, const double lastPositions[4], const double lastSpeeds[4]) {
 
-void SwerveTrain::zeroController(frc::Joystick *controller) {
+    double positions[4];
+    double moduleSpeeds[4];
+    getModuleSetpoints(speeds, centerOfRotation, positions, moduleSpeeds);
 
-    //This one is also built for being upside down, so invert it.
-    const double controllerTurningMagnitude = -controller->GetZ();
+    for (int module = 0; module < 4; module++) {
+
+        //No module can speed up or slow down faster than its wheel grips...
+        if (fabs(moduleSpeeds[module] - lastSpeeds[module]) > R_zionSetpointMaxDriveAcceleration * R_robotLoopPeriod) {
 
-    if (controller->GetRawButton(R_zeroButtonFR)) {
+            return false;
+        }
+        //Or turn faster than its swerve can, unless it is stopped on either
+        //end, where it is not driving in the direction it points anyway.
+        if (moduleSpeeds[module] > R_zionSetpointStoppedSpeed && lastSpeeds[module] > R_zionSetpointStoppedSpeed && fabs(remainder(positions[module] - lastPositions[module], R_nicsConstant)) > R_zionSetpointMaxSteeringRate * R_robotLoopPeriod) {
 
-        m_frontRight->setSwerveSpeed(controllerTurningMagnitude * R_executionCapControllerZero);
+            return false;
+        }
     }
-    else if (controller->GetRawButton(R_zeroButtonFL)) {
+    return true;
+}
+template <class Devices>
+void BasicSwerveTrain<Devices>::getModuleSetpoints(const ChassisSpeeds &speeds, const Vec2d &centerOfRotation, double positions[4], double moduleSpeeds[4]) {
+
+    double x;
+    double y;
+    double z;
+    getKinematicInputs(speeds, x, y, z);
+    calculateModuleTargets(x, y, z, 0, positions, moduleSpeeds, 0, 0, nullptr, centerOfRotation);
+    for (int module = 0; module < 4; module++) {
 
-        m_frontLeft->setSwerveSpeed(controllerTurningMagnitude * R_executionCapControllerZero);
+        moduleSpeeds[module] *= R_zionDriveMaxVelocity;
     }
-    else if (controller->GetRawButton(R_zeroButtonRL)) {
+    desaturateModuleSpeeds(moduleSpeeds, R_zionMaxModuleSpeed);
+}
+template <class Devices>
+void BasicSwerveTrain<Devices>::getKinematicInputs(const ChassisSpeeds &speeds, double &x, double &y, double &z) {
+
+    //The kinematics work in fractions of full speed, with X inverted (see
+    //calculateModuleTargets()).
+    x = -speeds.vx / R_zionDriveMaxVelocity;
+    y = speeds.vy / R_zionDriveMaxVelocity;
+    z = speeds.omega * R_zionModuleRadius / R_zionDriveMaxVelocity;
+}
+template <class Devices>
+double BasicSwerveTrain<Devices>::getHeadingRate(const double &z, const double speeds[4]) {
+
+    //The rotation part of every module's vector is Z long, and is driven at
+    //that fraction of full speed around a circle of the module radius...
+    const double largestSpeed = getLargestMagnitudeValue(speeds[0], speeds[1], speeds[2], speeds[3]) * R_zionDriveMaxVelocity;
+    double rotationSpeed = z * R_zionDriveMaxVelocity;
+    //Unless desaturation slows it down...
+    if (largestSpeed > R_zionMaxModuleSpeed) {
 
-        m_rearLeft->setSwerveSpeed(controllerTurningMagnitude * R_executionCapControllerZero);
+        rotationSpeed *= R_zionMaxModuleSpeed / largestSpeed;
     }
-    else if (controller->GetRawButton(R_zeroButtonRR)) {
+    //And a positive Z turns the robot counterclockwise, which (with the
+    //NavX upside down, like the rest of Zion) is a positive rate to it.
+    return rotationSpeed / R_zionModuleRadius * (180 / M_PI);
+}
+template <class Devices>
+void BasicSwerveTrain<Devices>::updateSteering() {
+
+    //The targets are always whole, and the latest the drivetrain's thread
+    //finished. New ones may be carried out for a while...
+    const SteeringTargets &targets = m_steeringTargets.read();
+    if (targets.generation != m_steeringTargetsRead) {
 
-        m_rearRight->setSwerveSpeed(controllerTurningMagnitude * R_executionCapControllerZero);
+        m_steeringTargetsRead = targets.generation;
+        m_steeringLoopsRemaining = (int)lround(R_swerveTrainSteeringTimeout * R_robotLoopPeriod / R_schedulerSteeringPeriod);
     }
-    else {
 
-        setZeroPosition();
+    BasicSwerveModule<Devices> *modules[4] = {m_frontRight, m_frontLeft, m_rearLeft, m_rearRight};
+    //But past that, the drivetrain's thread has stopped sending any, and
+    //nothing else will stop the swerves, so stop them, once.
+    if (m_steeringLoopsRemaining <= 0) {
+
+        if (!m_steeringStopped) {
+
+            for (int module = 0; module < 4; module++) {
+
+                modules[module]->setSwerveSpeed(0);
+            }
+            m_steeringStopped = true;
+        }
+        return;
     }
-}
+    m_steeringLoopsRemaining--;
+    m_steeringStopped = false;
 
-double SwerveTrain::getClockwiseREVRotationsFromCenter(frc::Joystick *controller) {
+    for (int module = 0; module < 4; module++) {
 
-    //Invert both the x and y once again, as the logic is written for an
-    //upside-down Zion...
-    const double x = -controller->GetX(frc::GenericHID::kLeftHand);
-    const double y = -controller->GetY(frc::GenericHID::kLeftHand);
-    //Create vectors for the line x = 0 and the line formed by the joystick coordinates...
-    VectorDouble center(0, 1);
-    VectorDouble current(x, y);
-
-    //Get the dot produt of the vectors for use in calculation...
-    const double dotProduct = center * current;
-    //Multiply each vector's magnitude together for use in calculation...
-    const double magnitudeProduct = center.magnitude() * current.magnitude();
-    //The cosine of the angle we want in rad is the dot product over the magnitude product...
-    const double cosineAngle = dotProduct / magnitudeProduct;
-    //The angle we want is the arccosine of its cosine...
-    double angleRad = acos(cosineAngle);
-    //If an imaginary situation is presented, set the angle equal to 0...
-    if (magnitudeProduct == 0) {
-
-       angleRad = 0;
-    }
-
-    //To go from a full 0pi to 2pi and overcome the limitation of arccos, jump
-    //to 2pi and subtract the gradually decreasing angle...
-    if (x < 0) {
-
-        angleRad = (2 * M_PI) - angleRad;
-    }
-    //The decimal total of the whole circle is the radians over 2pi...
-    double decimalTotalCircle = ((angleRad) / (2 * M_PI));
-    //And the amount of REV rotations we want to rotate is the decimal total by Nic's Constant.
-    return decimalTotalCircle * R_nicsConstant;
+        if (targets.steer) {
+
+            modules[module]->assumeSwervePosition(targets.positions[module], targets.rates[module]);
+        }
+        else {
+
+            modules[module]->setSwerveSpeed(targets.speeds[module]);
+        }
+    }
 }
-double SwerveTrain::getClockwiseREVRotationsFromCenter(const VectorDouble &vector) {
+template <class Devices>
+void BasicSwerveTrain<Devices>::updateSteeringDrift() {
 
-    const double x = vector.i;
-    const double y = vector.j;
-    VectorDouble center(0, 1);
-    VectorDouble current(x, y);
+    //Modules with absolute encoders check themselves...
+    BasicSwerveModule<Devices> *modules[4] = {m_frontRight, m_frontLeft, m_rearLeft, m_rearRight};
+    for (int module = 0; module < 4; module++) {
 
-    const double dotProduct = center * current;
-    const double magnitudeProduct = center.magnitude() * current.magnitude();
-    const double cosineAngle = dotProduct / magnitudeProduct;
-    double angleRad = acos(cosineAngle);
-    if (magnitudeProduct == 0) {
+        modules[module]->updateSteeringDrift();
+    }
 
-        angleRad = 0;
+    /*
+    The rest are checked against how the robot is really moving. Every wheel
+    of a rigid body moves at the body's velocity plus its turn, so take each
+    wheel's velocity as its encoders say (as a kinematic vector, like in
+    calculateModuleTargets()), take out the turn the NavX says the robot
+    made, and the average of what is left is the body's velocity. Where a
+    wheel should then be pointing, against where its encoder says it is, is
+    its drift. A drifted wheel pulls the average a little its way, and
+    scrubs along with the others rather than going where it points, so this
+    only sees part of it (see R_zionSteeringDriftCorrectionFromMotion). None
+    of this means anything while the swerves are still turning.
+    */
+    const double z = navX->getRate() * (M_PI / 180) * R_zionModuleRadius / R_zionDriveMaxVelocity;
+    double positions[4];
+    Vec2d wheelVectors[4];
+    Vec2d translationVector{0, 0};
+    for (int module = 0; module < 4; module++) {
+
+        if (fabs(modules[module]->getSwerveSpeed()) > R_zionSteeringDriftMaxSwerveSpeed) {
+
+            return;
+        }
+        positions[module] = modules[module]->getSwervePositionSingleRotation();
+        //The inverse of getStandardDegreeSwervePosition(), unrotated...
+        const double angle = (positions[module] / R_nicsConstant * 360. + 90.) * (M_PI / 180);
+        wheelVectors[module] = Vec2d{cos(angle), sin(angle)} * (modules[module]->getDriveVelocity() / R_zionDriveMaxVelocity);
+        translationVector += (wheelVectors[module] - wheelDirections[module] * z) / 4.;
     }
+    for (int module = 0; module < 4; module++) {
 
-    if (x < 0) {
+        const Vec2d expectedVector = translationVector + wheelDirections[module] * z;
+        //And a wheel barely rolling can point anywhere.
+        if (!modules[module]->getAbsoluteEncoderPresent() && expectedVector.norm() * R_zionDriveMaxVelocity > R_zionSteeringDriftMinSpeed) {
 
-        angleRad = (2 * M_PI) - angleRad;
+            modules[module]->addSteeringDriftSample(positions[module] - modules[module]->getStandardDegreeSwervePosition(expectedVector, 0), R_zionSteeringDriftCorrection && R_zionSteeringDriftCorrectionFromMotion);
+        }
     }
-    double decimalTotalCircle = ((angleRad) / (2 * M_PI));
-    return decimalTotalCircle * R_nicsConstant;
 }
-//TODO: Inline function documentation
-double SwerveTrain::getStandardDegreeAngleFromCenter(const double &x, const double &y) {
+template <class Devices>
+void BasicSwerveTrain<Devices>::zeroController(const ControllerState &controller) {
+
+    //This one is also built for being upside down, so invert it.
+    const double controllerTurningMagnitude = -controller.getAxis(ControllerState::kJoystickZ);
+    const int buttons[4] = {R_zeroButtonFR, R_zeroButtonFL, R_zeroButtonRL, R_zeroButtonRR};
 
-    VectorDouble center(0, 1);
-    VectorDouble current(x, y);
+    //While a module's button is held, turn its swerve with the stick. Like
+    //anything that turns the swerves, that is left to the thread that owns
+    //them...
+    for (int module = 0; module < 4; module++) {
 
-    const double dotProduct = center * current;
-    const double magnitudeProduct = center.magnitude() * current.magnitude();
-    const double cosineAngle = dotProduct / magnitudeProduct;
-    double angleRad = acos(cosineAngle);
-    if (magnitudeProduct == 0) {
+        if (controller.getButton(buttons[module])) {
 
-        angleRad = 0;
+            submit(DriveCommand::nudgeFromSource(DriveCommand::kTeleop, module, controllerTurningMagnitude * R_executionCapControllerZero));
+            return;
+        }
     }
+    //Once it is let go, stop it, and it is straight where it stopped.
+    for (int module = 0; module < 4; module++) {
 
-    if (x < 0) {
+        if (controller.getButtonReleased(buttons[module])) {
 
-        angleRad = (2 * M_PI) - angleRad;
+            submit(DriveCommand::stopFromSource(DriveCommand::kTeleop));
+            setZeroPosition();
+            return;
+        }
+    }
+    //Once every wheel is straight, keep it that way across power cycles.
+    if (controller.getButtonPressed(R_zeroButtonSave)) {
+
+        saveZeroPosition();
     }
-    angleRad *= (180. / M_PI);
-    return angleRad;
 }
+
+template <class Devices>
+Vec2d BasicSwerveTrain<Devices>::getCenterOfRotation(const int &center) {
+
+    //The corners of the bumpers, in meters to the right and forward.
+    const double corner = R_zionBumperHalfWidth * .0254;
+    switch (center) {
+
+        case kFrontLeftBumper: return {-corner, corner};
+        case kFrontRightBumper: return {corner, corner};
+        case kRearLeftBumper: return {-corner, -corner};
+        case kRearRightBumper: return {corner, -corner};
+        default: return {0, 0};
+    }
+}
+
+template <class Devices>
+double BasicSwerveTrain<Devices>::getClockwiseREVRotationsFromCenter(const ControllerState &controller) {
+
+    //Invert both the x and y once again, as the logic is written for an
+    //upside-down Zion...
+    const double x = -controller.getAxis(ControllerState::kJoystickX);
+    const double y = -controller.getAxis(ControllerState::kJoystickY);
+    //And the amount of REV rotations we want to rotate is the angle of the
+    //joystick clockwise from straight, in Nics. See Angle.h.
+    return Angle::clockwiseNicsFromCenter(x, y);
+}
+template <class Devices>
+double BasicSwerveTrain<Devices>::getClockwiseREVRotationsFromCenter(const Vec2d &vector) {
+
+    return Angle::clockwiseNicsFromCenter(vector.i, vector.j);
+}
+template <class Devices>
+double BasicSwerveTrain<Devices>::getStandardDegreeAngleFromCenter(const double &x, const double &y) {
+
+    return Angle::clockwiseDegreesFromCenter(x, y);
+}
+
+template class BasicSwerveTrain<RevDevices>;
+//The fakes are only built into the tests (see FakeDevices.h).
+#ifdef INCLUDE_FAKE_DEVICES
+template class BasicSwerveTrain<FakeDevices>;
+#endif
@@ -0,0 +1,96 @@
+/*
+namespace Angle
+
+    One place for turning vectors into angles. Everything is built on a
+        single atan2(), so there is no dot product, no division by a
+        magnitude, no arccosine, and no quadrant patching: every input,
+        including the zero vector, has a well-defined answer.
+
+    Two conventions are used in this project. "From center" angles are
+        measured clockwise from the positive Y axis (straight ahead), which
+        is how the swerves count REV rotations. "Standard" angles are
+        measured counterclockwise from the positive X axis, as on the unit
+        circle. All results are from 0 to one full rotation (2pi, 360, or
+        Nic's Constant). The zero vector is at 0.
+
+Functions
+
+    double atan2(const double&, const double&)
+        Returns the angle of Y over X in radians from -pi to pi, using either
+        the standard library or fastAtan2(), chosen by R_angleUseFastAtan2.
+    double fastAtan2(const double&, const double&)
+        Same as above, using a ninth degree polynomial (Abramowitz and
+        Stegun 4.4.48) instead of the standard library. It is accurate to
+        within R_angleFastAtan2MaxError (1.2e-5 radians, about seven
+        ten-thousandths of a degree or three hundred-thousandths of a Nic),
+        which GoldenCheck confirms.
+    double clockwiseRadiansFromCenter(const double&, const double&)
+    double clockwiseDegreesFromCenter(const double&, const double&)
+    double clockwiseNicsFromCenter(const double&, const double&)
+        Return the angle of the vector X, Y clockwise from straight ahead in
+        radians, degrees, or Nics.
+    double standardRadians(const double&, const double&)
+    double standardDegrees(const double&, const double&)
+        Return the angle of the vector X, Y in standard position in radians
+        or degrees.
+*/
+
+#pragma once
+
+#include <math.h>
+
+#include "RobotMap.h"
+
+namespace Angle {
+
+    inline double fastAtan2(const double &y, const double &x) {
+
+        //Fold everything into the first octant, where the ratio of the
+        //smaller side over the larger is from 0 to 1...
+        const double absX = fabs(x);
+        const double absY = fabs(y);
+        const double smaller = fmin(absX, absY);
+        const double larger = fmax(absX, absY);
+        const double ratio = larger == 0 ? 0 : smaller / larger;
+        const double ratioSquared = ratio * ratio;
+        //Approximate the arctangent there...
+        double angle = ratio * (.9998660 + ratioSquared * (-.3302995 + ratioSquared * (.1801410 + ratioSquared * (-.0851330 + ratioSquared * .0208351))));
+        //And unfold it back out into the right octant. These compile down to
+        //selects rather than branches.
+        angle = absY > absX ? M_PI_2 - angle : angle;
+        angle = x < 0 ? M_PI - angle : angle;
+        return copysign(angle, y);
+    }
+    inline double atan2(const double &y, const double &x) {
+
+        return R_angleUseFastAtan2 ? fastAtan2(y, x) : ::atan2(y, x);
+    }
+
+    inline double clockwiseRadiansFromCenter(const double &x, const double &y) {
+
+        //Clockwise from Y is the same as counterclockwise from X with the
+        //axes swapped. Adding zero turns a negative zero positive, so the
+        //zero vector is always at 0 instead of sometimes half a rotation.
+        //Then wrap the negative half of the circle up to positive.
+        const double angle = Angle::atan2(x + 0., y + 0.);
+        return angle + (angle < 0) * (2 * M_PI);
+    }
+    inline double clockwiseDegreesFromCenter(const double &x, const double &y) {
+
+        return clockwiseRadiansFromCenter(x, y) * (180 / M_PI);
+    }
+    inline double clockwiseNicsFromCenter(const double &x, const double &y) {
+
+        return clockwiseRadiansFromCenter(x, y) * (R_nicsConstant / (2 * M_PI));
+    }
+
+    inline double standardRadians(const double &x, const double &y) {
+
+        const double angle = Angle::atan2(y + 0., x + 0.);
+        return angle + (angle < 0) * (2 * M_PI);
+    }
+    inline double standardDegrees(const double &x, const double &y) {
+
+        return standardRadians(x, y) * (180 / M_PI);
+    }
+}
@@ -0,0 +1,51 @@
+/*
+struct ChassisSpeeds
+
+    How fast the whole robot should move, independent of where the command
+        came from: a driver's joystick (see DriveInput.h), Hal, or anything
+        else that wants to drive Zion. It is a plain aggregate, built with
+        braces (ChassisSpeeds speeds{vx, vy, omega}).
+
+    vx is to the right and vy is forward, both in meters per second, and
+    omega is counterclockwise in radians per second. Whether right and
+    forward are the robot's or the field's is up to whoever drives with it;
+    see BasicSwerveTrain::drive().
+
+Public Methods
+
+    static ChassisSpeeds fromFractions(const double&, const double&, const double&)
+        Returns the speeds for a right, forward, and counterclockwise
+        fraction of full speed, each from -1 to 1, the way the joystick and
+        the old drivetrain functions counted them. A full turn drives the
+        modules around the robot at full speed.
+    bool isZero()
+        Returns true if the robot should not move at all.
+    ChassisSpeeds interpolate(const ChassisSpeeds&, const double&)
+        Returns the speeds the supplied fraction of the way from these to
+        the supplied ones.
+*/
+
+#pragma once
+
+#include "RobotMap.h"
+
+struct ChassisSpeeds {
+
+        static constexpr ChassisSpeeds fromFractions(const double &right, const double &forward, const double &counterclockwise) {
+
+            return {right * R_zionDriveMaxVelocity, forward * R_zionDriveMaxVelocity, counterclockwise * R_zionDriveMaxVelocity / R_zionModuleRadius};
+        }
+
+        constexpr bool isZero() const {
+
+            return vx == 0 && vy == 0 && omega == 0;
+        }
+        constexpr ChassisSpeeds interpolate(const ChassisSpeeds &other, const double &fraction) const {
+
+            return {vx + (other.vx - vx) * fraction, vy + (other.vy - vy) * fraction, omega + (other.omega - omega) * fraction};
+        }
+
+        double vx;
+        double vy;
+        double omega;
+};
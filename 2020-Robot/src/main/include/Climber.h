@@ -1,5 +1,7 @@
 /*
-class Climber
+class BasicClimber<Devices>
+
+    Usually used as Climber, which is built on RevDevices. See Devices.h.
 
 Constructors
 
@@ -9,12 +11,19 @@ Constructors
         on the supplied PWM ports, and its servo for locking its ratchet
         on another PWM port. Take a final argument for a DIO pin to attach
         a limit switch to which denotes the bottom position of the arm.
+        The switch is watched by an FPGA interrupt, so the moment it
+        closes the climb motor is cut, from the interrupt's thread, without
+        waiting for the next loop to call setSpeed().
 
 Public Methods
 
     void setSpeed(const int&, const double& = 0)
         Sets the speed of the supplied LiftMotor to the passed double
-        (defaults to 0).
+        (defaults to 0). The climb motor is never driven down while the arm
+        is at the bottom.
+    bool getAtBottom()
+        Returns true if the arm is at the bottom, as latched by the
+        interrupt when the switch closed, until it opens again.
     void lock(const bool& = true)
         If true, locks the climber in the up direction. If false or null,
         unlocks it. Persists across calls (it's hardware ;)). Defaults to
@@ -26,22 +35,38 @@ Public Methods
 
 #pragma once
 
-#include <frc/DigitalInput.h>
-#include <frc/Servo.h>
-#include <frc/VictorSP.h>
-
-class Climber {
-
-    public:
-        Climber(const int &climbMotorPWMPort, const int &translateMotorPWMPort, const int &wheelMotorPWMPort, const int &servoPWMPort, const int &limitDIOPort) {
+#include <atomic>
 
-            m_climbMotor = new frc::VictorSP(climbMotorPWMPort);
-            m_translateMotor = new frc::VictorSP(translateMotorPWMPort);
-            m_wheelMotor = new frc::VictorSP(wheelMotorPWMPort);
+#include "Devices.h"
 
-            m_ratchetServo = new frc::Servo(servoPWMPort);
+template <class Devices>
+class BasicClimber {
 
-            m_limitBottom = new frc::DigitalInput(limitDIOPort);
+    public:
+        BasicClimber(const int &climbMotorPWMPort, const int &translateMotorPWMPort, const int &wheelMotorPWMPort, const int &servoPWMPort, const int &limitDIOPort) {
+
+            m_climbMotor = new typename Devices::VictorSP(climbMotorPWMPort);
+            m_translateMotor = new typename Devices::VictorSP(translateMotorPWMPort);
+            m_wheelMotor = new typename Devices::VictorSP(wheelMotorPWMPort);
+
+            m_ratchetServo = new typename Devices::Servo(servoPWMPort);
+
+            m_limitBottom = new typename Devices::DigitalInput(limitDIOPort);
+            //Switches are normally open, so invert: reaching the bottom is
+            //a falling edge, and leaving it a rising one.
+            m_atBottom = !m_limitBottom->Get();
+            m_limitBottom->RequestInterrupts([this](typename Devices::DigitalInput::WaitResult result) {
+
+                //Read the switch rather than trust the edge, in case it
+                //bounced on the way.
+                m_atBottom = !m_limitBottom->Get();
+                if (m_atBottom && m_climbSpeed < 0) {
+
+                    m_climbMotor->Set(0);
+                }
+            });
+            m_limitBottom->SetUpSourceEdge(true, true);
+            m_limitBottom->EnableInterrupts();
         }
 
         void setSpeed(const int &motor, double speedToSet = 0) {
@@ -51,21 +76,26 @@ class Climber {
                 case Motor::kClimb:
                     //If a downward direction is wanted, do not allow it to
                     //happen if the bottom position is already reached.
-                    if (speedToSet < 0) {
-
-                        //Switches are normally open, so invert.
-                        if (!m_limitBottom->Get()) {
+                    if (speedToSet < 0 && m_atBottom) {
 
-                            speedToSet = 0;
-                        }
+                        speedToSet = 0;
                     }
+                    m_climbSpeed = speedToSet;
                     m_climbMotor->Set(speedToSet);
+                    //If the interrupt fired while this was being set, it
+                    //may have cut the motor just before this set it again,
+                    //so check once more.
+                    if (speedToSet < 0 && m_atBottom) {
+
+                        m_climbSpeed = 0;
+                        m_climbMotor->Set(0);
+                    }
                     break;
                 //This motor is mounted upside-down, so invert it.
                 case Motor::kTranslate: m_translateMotor->Set(-speedToSet); break;
                 case Motor::kWheel: m_wheelMotor->Set(speedToSet); break;
                 case Motor::kAll:
-                    m_climbMotor->Set(speedToSet);
+                    setSpeed(Motor::kClimb, speedToSet);
                     m_translateMotor->Set(speedToSet);
                     m_wheelMotor->Set(speedToSet);
                     break;
@@ -84,17 +114,28 @@ class Climber {
             }
         }
 
+        bool getAtBottom() {
+
+            return m_atBottom;
+        }
+
         enum Motor {
 
             kClimb, kTranslate, kWheel, kAll
         };
 
     private:
-        frc::VictorSP *m_climbMotor;
-        frc::VictorSP *m_translateMotor;
-        frc::VictorSP *m_wheelMotor;
+        typename Devices::VictorSP *m_climbMotor;
+        typename Devices::VictorSP *m_translateMotor;
+        typename Devices::VictorSP *m_wheelMotor;
+
+        typename Devices::Servo *m_ratchetServo;
 
-        frc::Servo *m_ratchetServo;
+        typename Devices::DigitalInput *m_limitBottom;
 
-        frc::DigitalInput *m_limitBottom;
+        //Shared with the interrupt's thread.
+        std::atomic<bool> m_atBottom;
+        std::atomic<double> m_climbSpeed{0};
 };
+
+using Climber = BasicClimber<RevDevices>;
@@ -0,0 +1,104 @@
+/*
+class CommandQueue<T, Size>
+
+    Hands commands (usually small structs of plain values) from any number
+        of threads to the one thread that carries them out, without a lock.
+        It holds at most Size commands, which must be a power of two, in a
+        ring of slots. Each slot has a sequence number saying whose turn it
+        is: a thread pushing claims the next slot with one compare-exchange
+        on the tail, fills it, then bumps its sequence to hand it to the
+        reader, who bumps it once more, a lap on, to hand it back. No thread
+        ever waits on another to finish, so a command can be pushed from
+        the steering thread or the main loop alike.
+
+    Any number of threads may push, but only one may pop.
+
+Constructors
+
+    CommandQueue()
+        Creates an empty queue.
+
+Public Methods
+
+    bool push(const T&)
+        Adds the supplied command to the back of the queue. Returns false,
+        and drops it, if the queue is full. Called from any thread.
+    bool pop(T&)
+        Takes the command at the front of the queue into the supplied one.
+        Returns false, leaving it alone, if the queue is empty. Called only
+        from the reading thread.
+*/
+
+#pragma once
+
+#include <atomic>
+
+template <typename T, int Size>
+class CommandQueue {
+
+    static_assert(Size > 0 && (Size & (Size - 1)) == 0, "CommandQueue Size must be a power of two");
+
+    public:
+        CommandQueue() {
+
+            for (int slot = 0; slot < Size; slot++) {
+
+                m_slots[slot].sequence = slot;
+            }
+        }
+
+        bool push(const T &command) {
+
+            unsigned position = m_tail.load(std::memory_order_relaxed);
+            while (true) {
+
+                Slot &slot = m_slots[position & (Size - 1)];
+                //The slot is free for this lap if its sequence has caught up
+                //to the position, and still full from the last one if it is
+                //behind...
+                const int lap = (int)(slot.sequence.load(std::memory_order_acquire) - position);
+                if (lap == 0) {
+
+                    if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+
+                        slot.command = command;
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (lap < 0) {
+
+                    return false;
+                }
+                //Otherwise another thread claimed it first, so try the next.
+                else {
+
+                    position = m_tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+        bool pop(T &command) {
+
+            Slot &slot = m_slots[m_head & (Size - 1)];
+            //A slot is only full once its writer has finished with it.
+            if ((int)(slot.sequence.load(std::memory_order_acquire) - (m_head + 1)) < 0) {
+
+                return false;
+            }
+            command = slot.command;
+            slot.sequence.store(m_head + Size, std::memory_order_release);
+            m_head++;
+            return true;
+        }
+
+    private:
+        struct Slot {
+
+            std::atomic<unsigned> sequence;
+            T command;
+        };
+
+        Slot m_slots[Size];
+        std::atomic<unsigned> m_tail{0};
+        unsigned m_head = 0;
+};
@@ -0,0 +1,166 @@
+/*
+class ControlLayers<Input, Actuators>
+
+    Decides, each loop, which of several control layers (like P2's manual
+        override, climber, and auto layers) gets to set each of the robot's
+        actuators. Every layer is added once, with a priority, the
+        actuators it claims, when it is active, and what it sets them to.
+        resolve() then makes one pass down the layers from the highest
+        priority: an active layer owns whichever of its actuators no higher
+        one has already claimed, and can only set those. Anything no layer
+        owns stays at its default. Layers whose actuators are all taken
+        are not even checked, so the cost of a loop stays with the number
+        of layers that matter rather than growing with every one added.
+
+    Input is whatever the layers read the controls from, handed to each of
+    them as is. Actuators is how many there are, numbered from zero (usually
+    by an enum), each set to a double (a speed, or one or zero for
+    something on or off). At most 32.
+
+Constructors
+
+    ControlLayers()
+        Creates an arbitrator with no layers, and every actuator defaulting
+        to zero.
+
+Public Methods
+
+    void setDefault(const int&, const double&)
+        Sets what the supplied actuator is set to when no layer owns it.
+    void addLayer(const std::string&, const int&, const unsigned&, std::function<bool(const Input&)>, std::function<void(const Input&, Frame&)>)
+        Adds a layer, under the supplied name, at the supplied priority
+        (higher overrides lower, and the first added wins a tie), claiming
+        the actuators whose bits are set in the supplied mask (see
+        getClaim()). It is active when the first function returns true,
+        and sets its actuators through the second.
+    const Frame &resolve(const Input&)
+        Works out which layer owns each actuator for the supplied input,
+        and returns what every actuator is set to.
+    std::string getOwner(const int&)
+        Returns the name of the layer that owned the supplied actuator in
+        the last resolve(), or an empty string if none did.
+    static unsigned getClaim(const int&)
+        Returns the mask bit for the supplied actuator, to be ORed together
+        into a layer's claim.
+
+    class Frame
+        What every actuator is set to for one loop, read with get(const
+        int&). Layers set theirs with set(const int&, const double&), which
+        ignores any actuator the layer does not own.
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+template <typename Input, int Actuators>
+class ControlLayers {
+
+    static_assert(Actuators > 0 && Actuators <= 32, "ControlLayers holds 1 to 32 actuators");
+
+    public:
+        class Frame {
+
+            public:
+                void set(const int &actuator, const double &value) {
+
+                    if (m_writable & getClaim(actuator)) {
+
+                        m_values[actuator] = value;
+                    }
+                }
+                double get(const int &actuator) const {
+
+                    return m_values[actuator];
+                }
+
+            private:
+                friend class ControlLayers;
+
+                double m_values[Actuators] = {};
+                //The actuators the layer being applied owns.
+                unsigned m_writable = 0;
+        };
+
+        ControlLayers() {
+
+            for (int actuator = 0; actuator < Actuators; actuator++) {
+
+                m_owners[actuator] = -1;
+            }
+        }
+
+        void setDefault(const int &actuator, const double &value) {
+
+            m_defaults[actuator] = value;
+        }
+        void addLayer(const std::string &name, const int &priority, const unsigned &claims, std::function<bool(const Input&)> active, std::function<void(const Input&, Frame&)> apply) {
+
+            //Keep them highest priority first, so that resolve() only has to
+            //walk down them once.
+            auto layer = m_layers.begin();
+            while (layer != m_layers.end() && layer->priority >= priority) {
+
+                layer++;
+            }
+            m_layers.insert(layer, {name, priority, claims, active, apply});
+        }
+        const Frame &resolve(const Input &input) {
+
+            for (int actuator = 0; actuator < Actuators; actuator++) {
+
+                m_frame.m_values[actuator] = m_defaults[actuator];
+                m_owners[actuator] = -1;
+            }
+            unsigned claimed = 0;
+            for (int layer = 0; layer < (int)m_layers.size(); layer++) {
+
+                //Everything this layer could set is already someone else's,
+                //so whether it is active does not matter.
+                const unsigned owned = m_layers[layer].claims & ~claimed;
+                if (owned == 0 || !m_layers[layer].active(input)) {
+
+                    continue;
+                }
+                //A layer claims everything it asks for while active, even
+                //what it leaves at the default, so nothing lower sets it.
+                claimed |= owned;
+                for (int actuator = 0; actuator < Actuators; actuator++) {
+
+                    if (owned & getClaim(actuator)) {
+
+                        m_owners[actuator] = layer;
+                    }
+                }
+                m_frame.m_writable = owned;
+                m_layers[layer].apply(input, m_frame);
+            }
+            m_frame.m_writable = 0;
+            return m_frame;
+        }
+        std::string getOwner(const int &actuator) {
+
+            return m_owners[actuator] < 0 ? "" : m_layers[m_owners[actuator]].name;
+        }
+        static unsigned getClaim(const int &actuator) {
+
+            return 1u << actuator;
+        }
+
+    private:
+        struct Layer {
+
+            std::string name;
+            int priority;
+            unsigned claims;
+            std::function<bool(const Input&)> active;
+            std::function<void(const Input&, Frame&)> apply;
+        };
+
+        std::vector<Layer> m_layers;
+        double m_defaults[Actuators] = {};
+        int m_owners[Actuators];
+        Frame m_frame;
+};
@@ -0,0 +1,209 @@
+/*
+struct ControllerState
+
+    Everything one controller was doing at one moment: its axes, buttons,
+        and POV, copied out of the Driver Station data all at once, plus
+        which buttons went down or up since the copy before, and when the
+        copy was taken. Reading it is only reading memory, so it can be read
+        as often as is convenient, and every reader in a loop sees the same
+        thing. Made by Controllers::update(); never changed once made.
+
+    Buttons are numbered from one, as on the Driver Station. Axes and
+    buttons past what the controller has read as zero and released.
+
+Public Methods
+
+    double getAxis(const int&)
+        Returns the supplied axis, from -1 to 1.
+    bool getButton(const int&)
+        Returns true if the supplied button is held.
+    bool getButtonPressed(const int&)
+        Returns true if the supplied button went down since the last
+        update().
+    bool getButtonReleased(const int&)
+        Returns true if the supplied button came up since the last update().
+    int getPOV()
+        Returns the angle of the POV hat in degrees clockwise from up, or
+        -1 if it is not pushed.
+    double getTimestamp()
+        Returns the FPGA time, in seconds, the state was taken at.
+
+    enum JoystickAxes
+        The axes of playerOne's joystick: kJoystickX, kJoystickY, and
+        kJoystickZ, as frc::Joystick numbers them.
+    enum XboxAxes
+        The axes of playerTwo's Xbox controller, as frc::XboxController
+        numbers them: kXboxLeftX, kXboxLeftY, kXboxLeftTrigger,
+        kXboxRightTrigger, kXboxRightX, and kXboxRightY.
+    enum XboxButtons
+        The same for its buttons: kXboxA, kXboxB, kXboxX, kXboxY,
+        kXboxBumperLeft, kXboxBumperRight, kXboxBack, kXboxStart,
+        kXboxStickLeft, and kXboxStickRight.
+
+class Controllers
+
+    Reads both drivers' controllers once a loop, so that nothing else goes
+        through the Driver Station's data lock for them, and keeps track of
+        how old the Driver Station's data is when it is read, which is how
+        late the robot is to anything the drivers do.
+
+Constructors
+
+    Controllers(const int&, const int&)
+        Creates the controllers for playerOne and playerTwo on the
+        supplied Driver Station ports.
+
+Public Methods
+
+    void update()
+        Takes a new ControllerState of each controller. Called once at the
+        start of every loop, before anything reads them.
+    const ControllerState &getPlayerOne()
+        Returns playerOne's state as of the last update().
+    const ControllerState &getPlayerTwo()
+        Same as above for playerTwo.
+    double getPacketAge()
+        Returns how long, in seconds, it had been since the Driver Station
+        last sent new data at the last update().
+    void publish()
+        Puts the packet age, and the oldest it has been, to the
+        SmartDashboard under Controllers::. Called from any thread.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+
+#include <frc/DriverStation.h>
+#include <frc/Timer.h>
+#include <frc/smartdashboard/SmartDashboard.h>
+
+#include "RobotMap.h"
+
+struct ControllerState {
+
+        double getAxis(const int &axis) const {
+
+            return axis >= 0 && axis < R_controllerMaxAxes ? axes[axis] : 0;
+        }
+        bool getButton(const int &button) const {
+
+            return buttons & getMask(button);
+        }
+        bool getButtonPressed(const int &button) const {
+
+            return pressed & getMask(button);
+        }
+        bool getButtonReleased(const int &button) const {
+
+            return released & getMask(button);
+        }
+        int getPOV() const {
+
+            return pov;
+        }
+        double getTimestamp() const {
+
+            return timestamp;
+        }
+
+        enum JoystickAxes {
+
+            kJoystickX = 0, kJoystickY = 1, kJoystickZ = 2
+        };
+        enum XboxAxes {
+
+            kXboxLeftX = 0, kXboxLeftY = 1, kXboxLeftTrigger = 2, kXboxRightTrigger = 3, kXboxRightX = 4, kXboxRightY = 5
+        };
+        enum XboxButtons {
+
+            kXboxA = 1, kXboxB, kXboxX, kXboxY, kXboxBumperLeft, kXboxBumperRight, kXboxBack, kXboxStart, kXboxStickLeft, kXboxStickRight
+        };
+
+        static unsigned getMask(const int &button) {
+
+            return button >= 1 && button <= 32 ? 1u << (button - 1) : 0;
+        }
+
+        double axes[R_controllerMaxAxes];
+        //One bit per button, the first button in the lowest.
+        unsigned buttons;
+        unsigned pressed;
+        unsigned released;
+        int pov;
+        double timestamp;
+};
+
+class Controllers {
+
+    public:
+        Controllers(const int &portPlayerOne, const int &portPlayerTwo) : m_portPlayerOne(portPlayerOne), m_portPlayerTwo(portPlayerTwo) {}
+
+        void update() {
+
+            //The Driver Station says whether it has sent anything since it
+            //was last asked, so only ever ask here.
+            const double now = frc::Timer::GetFPGATimestamp();
+            if (frc::DriverStation::GetInstance().IsNewControlData()) {
+
+                m_packetTime = now;
+            }
+            m_packetAge = now - m_packetTime;
+            if (m_packetAge.load() > m_maxPacketAge.load()) {
+
+                m_maxPacketAge = m_packetAge.load();
+            }
+
+            m_statePlayerOne = read(m_portPlayerOne, m_statePlayerOne, now);
+            m_statePlayerTwo = read(m_portPlayerTwo, m_statePlayerTwo, now);
+        }
+        const ControllerState &getPlayerOne() {
+
+            return m_statePlayerOne;
+        }
+        const ControllerState &getPlayerTwo() {
+
+            return m_statePlayerTwo;
+        }
+        double getPacketAge() {
+
+            return m_packetAge;
+        }
+        void publish() {
+
+            frc::SmartDashboard::PutNumber("Controllers::PacketAge", m_packetAge);
+            frc::SmartDashboard::PutNumber("Controllers::MaxPacketAge", m_maxPacketAge);
+        }
+
+    private:
+        ControllerState read(const int &port, const ControllerState &last, const double &timestamp) {
+
+            //Straight from the Driver Station by port, rather than through
+            //frc::GenericHID one axis or button at a time. The buttons come
+            //as one mask, numbered the same way as ControllerState's.
+            frc::DriverStation &driverStation = frc::DriverStation::GetInstance();
+            ControllerState state{};
+            const int axes = std::min(driverStation.GetStickAxisCount(port), R_controllerMaxAxes);
+            for (int axis = 0; axis < axes; axis++) {
+
+                state.axes[axis] = driverStation.GetStickAxis(port, axis);
+            }
+            state.buttons = driverStation.GetStickButtons(port);
+            state.pressed = state.buttons & ~last.buttons;
+            state.released = last.buttons & ~state.buttons;
+            state.pov = driverStation.GetStickPOV(port, 0);
+            state.timestamp = timestamp;
+            return state;
+        }
+
+        int m_portPlayerOne;
+        int m_portPlayerTwo;
+        ControllerState m_statePlayerOne{};
+        ControllerState m_statePlayerTwo{};
+
+        double m_packetTime = 0;
+        //Read by publish() from the telemetry thread.
+        std::atomic<double> m_packetAge{0};
+        std::atomic<double> m_maxPacketAge{0};
+};
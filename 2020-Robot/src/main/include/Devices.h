@@ -0,0 +1,68 @@
+/*
+struct RevDevices
+
+    Device policies for the robot classes. Every class that owns a motor
+        controller or sensor (SwerveModule, SwerveTrain, NavX, Climber,
+        Intake, Launcher, and Hal) is a template on one of these, and takes
+        all of its device types from it. The usual names for those classes
+        (SwerveModule, NavX, ...) are the RevDevices versions, which are
+        exactly the vendor classes, so they compile straight down to the
+        vendor calls with no virtual dispatch. The only other policy is
+        FakeDevices (see FakeDevices.h), which is only built where
+        INCLUDE_FAKE_DEVICES is defined (see build.gradle), so none of it
+        is in the robot program.
+
+    Types
+        SparkMax, SparkMaxEncoder, SparkMaxPIDController
+            A Spark MAX and the encoder and PID controller it returns from
+            GetEncoder() and GetPIDController().
+        ControlType
+            What a SparkMaxPIDController reference is (kVelocity, ...).
+        Gyro
+            A NavX, constructed on an frc::SPI::Port. The NavX library is
+            only built for the roboRIO, so in the tests, which are built for
+            the desktop, this is a FakeAHRS, picked by FAKE_NAVX (see
+            build.gradle). Nothing else defines FAKE_NAVX, and the robot
+            program fails to build for anything but the roboRIO rather than
+            run on a fake gyro.
+        VictorSP, Servo, DigitalInput, AnalogInput
+            PWM speed controllers, servos, and DIO and analog inputs.
+        Preferences
+            The store of values that persist on the roboRIO across reboots.
+*/
+
+#pragma once
+
+#include <frc/AnalogInput.h>
+#include <frc/DigitalInput.h>
+#include <frc/Preferences.h>
+#include <frc/Servo.h>
+#include <frc/VictorSP.h>
+
+#include "rev/CANSparkMax.h"
+
+#ifdef FAKE_NAVX
+#include "FakeDevices.h"
+#elif defined(__FRC_ROBORIO__)
+#include "AHRS.h"
+#else
+#error "There is no NavX library for the desktop, so the robot program only builds for the roboRIO. Only the tests, with FAKE_NAVX, build for the desktop (see build.gradle)."
+#endif
+
+struct RevDevices {
+
+    using SparkMax = rev::CANSparkMax;
+    using SparkMaxEncoder = rev::CANEncoder;
+    using SparkMaxPIDController = rev::CANPIDController;
+    using ControlType = rev::ControlType;
+#ifdef FAKE_NAVX
+    using Gyro = FakeAHRS;
+#else
+    using Gyro = AHRS;
+#endif
+    using VictorSP = frc::VictorSP;
+    using Servo = frc::Servo;
+    using DigitalInput = frc::DigitalInput;
+    using AnalogInput = frc::AnalogInput;
+    using Preferences = frc::Preferences;
+};
@@ -0,0 +1,110 @@
+/*
+struct DriveCommand
+
+    One request to drive Zion, as handed to BasicSwerveTrain::submit() by
+        whatever wants to: the driver's joystick or a step of Hal. Besides
+        the arguments to BasicSwerveTrain::drive(), it carries what to do
+        with them, where it came from, how much it matters, and when it was
+        made, so that the drivetrain can pick between sources that disagree
+        and stop on its own when one goes quiet. It is a plain aggregate,
+        usually made with fromSource().
+
+Public Methods
+
+    static DriveCommand fromSource(const int&, const ChassisSpeeds&, const bool& = true, const Vec2d& = {0, 0})
+        Returns a command from the supplied Sources, made now, at that
+        source's priority (see RobotMap.h), to drive at the supplied
+        speeds, relative to the field if the bool is true, turning about
+        the supplied center of rotation.
+    static DriveCommand fromAction(const int&, const int&)
+        Returns a command from the supplied Sources, made now, to carry out
+        the supplied Actions, with no speeds.
+    static DriveCommand stopFromSource(const int&)
+        Returns a command from the supplied Sources to stop dead, as
+        BasicSwerveTrain::setDriveSpeed() does, rather than slowing to a
+        stop through the setpoint generator. Used by Hal to stop exactly
+        where it measured to.
+    static DriveCommand pointFromSource(const int&, const ChassisSpeeds&)
+        Returns a command from the supplied Sources to stop the drives and
+        only point the swerves the way the supplied speeds, relative to the
+        robot, would translate it.
+    static DriveCommand nudgeFromSource(const int&, const int&, const double&)
+        Returns a command from the supplied Sources to stop the drives and
+        turn only the supplied module (front right, front left, rear left,
+        then rear right, from 0) at the supplied swerve speed, by hand, for
+        calibrating (see BasicSwerveTrain::zeroController()).
+    static double now()
+        Returns the time commands are stamped with, in seconds, from a
+        clock every thread shares.
+
+    enum Sources
+        Where a command came from: kTeleop or kHal.
+    enum Actions
+        What a command asks for: kDrive at its speeds, kStop dead, kPoint
+        the swerves, kStraighten them (point them at their nearest zero
+        position), kNudge them at their swerveSpeeds, or kSetZeroPosition,
+        kLoadZeroPosition, or kSaveZeroPosition, which calibrate the
+        swerves (see BasicSwerveTrain::setZeroPosition()) and are carried
+        out whatever their source or age.
+*/
+
+#pragma once
+
+#include <chrono>
+
+#include "ChassisSpeeds.h"
+#include "RobotMap.h"
+#include "Vec2.h"
+
+struct DriveCommand {
+
+        enum Sources {
+
+            kTeleop, kHal
+        };
+        enum Actions {
+
+            kDrive, kStop, kPoint, kStraighten, kNudge, kSetZeroPosition, kLoadZeroPosition, kSaveZeroPosition
+        };
+
+        static DriveCommand fromSource(const int &source, const ChassisSpeeds &speeds, const bool &fieldRelative = true, const Vec2d &centerOfRotation = {0, 0}) {
+
+            const int priority = source == kHal ? R_driveCommandPriorityHal : R_driveCommandPriorityTeleop;
+            return {speeds, fieldRelative, centerOfRotation, {0, 0, 0, 0}, kDrive, source, priority, now()};
+        }
+        static DriveCommand fromAction(const int &source, const int &action) {
+
+            DriveCommand command = fromSource(source, {0, 0, 0});
+            command.action = action;
+            return command;
+        }
+        static DriveCommand stopFromSource(const int &source) {
+
+            return fromAction(source, kStop);
+        }
+        static DriveCommand pointFromSource(const int &source, const ChassisSpeeds &speeds) {
+
+            DriveCommand command = fromSource(source, speeds, false);
+            command.action = kPoint;
+            return command;
+        }
+        static DriveCommand nudgeFromSource(const int &source, const int &module, const double &swerveSpeed) {
+
+            DriveCommand command = fromAction(source, kNudge);
+            command.swerveSpeeds[module] = swerveSpeed;
+            return command;
+        }
+        static double now() {
+
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        ChassisSpeeds speeds;
+        bool fieldRelative;
+        Vec2d centerOfRotation;
+        double swerveSpeeds[4];
+        int action;
+        int source;
+        int priority;
+        double timestamp;
+};
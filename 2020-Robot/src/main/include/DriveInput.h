@@ -0,0 +1,194 @@
+/*
+namespace DriveInput
+
+    Turns a driver's joystick, as of the loop's ControllerState (see
+        Controllers.h), into ChassisSpeeds. Everything about how the stick
+        feels (its deadzones, its curve, how quickly it can swing, making
+        rotation harder to induce while strafing, and how much of full
+        speed each axis is worth) lives here, so the drivetrain only ever
+        sees how fast the robot should move, and is driven the same way by
+        Hal and anything else.
+
+    Each step is a plain function of a few doubles, so they can be put
+    together in any order and nothing is ever allocated. getChassisSpeeds()
+    and Shaper put them together the way Zion is driven, tuned by the
+    R_deadzone and R_input constants in RobotMap.h.
+
+Functions
+
+    bool getInDeadzone(const ControllerState&)
+        If the stick is within R_deadzoneController of center (measured
+        as a circle, not per axis) and its twist within
+        R_deadzoneControllerZ, returns true; otherwise, returns false.
+    ChassisSpeeds getChassisSpeeds(const ControllerState&, const double&, const double&)
+        Reads the controller, runs it through its deadzones and curves,
+        and returns the speeds it asks for, with translation scaled by the
+        first supplied execution cap and rotation by whichever of the two
+        is lower, so it is only ever capped once.
+    void getFractions(const ControllerState&, double&, double&, double&)
+        Fills in the right, forward, and counterclockwise fractions of full
+        speed the controller asks for, from -1 to 1, before any execution
+        cap, for getChassisSpeeds() and Shaper.
+    Vec2d applyRadialDeadzone(const Vec2d&, const double&)
+        Returns zero if the supplied stick is within the supplied deadzone
+        of center. Otherwise, keeps its direction and rescales its
+        magnitude so that it starts from zero at the edge of the deadzone
+        and reaches one at full, so there is neither a jump at the edge
+        nor a cross along the axes where one axis is stuck at zero.
+    double applyDeadzone(const double&, const double&)
+        Same as above, for one axis.
+    double applyExpo(const double&, const double&)
+        Bends the supplied value from -1 to 1 toward its cube by the
+        supplied fraction (zero is linear, one is cubic), keeping both ends
+        where they are, so that small movements of the stick are finer.
+    double getDeadzoneZ(const double&)
+        Returns the twist deadzone for the supplied stick magnitude: the
+        faster the stick is pushed, the further Z has to be twisted to
+        count, which makes strafing with a joystick much more reliable.
+
+    class SlewLimiter
+        Follows a value, changing by no more than the supplied amount per
+        call: calculate(const double&, const double&) takes the value and
+        the largest change and returns the limited value, and reset(const
+        double& = 0) jumps straight to the supplied one.
+    class Shaper
+        getChassisSpeeds() with each fraction of full speed limited to
+        changing by R_inputSlewRate per second, so that a flick of the
+        stick does not become a jolt of the drivetrain. Has the same
+        getChassisSpeeds(), called once a loop, and reset(), for when the
+        stick is let go.
+*/
+
+#pragma once
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "ChassisSpeeds.h"
+#include "Controllers.h"
+#include "RobotMap.h"
+#include "Vec2.h"
+
+namespace DriveInput {
+
+    inline Vec2d applyRadialDeadzone(const Vec2d &stick, const double &deadzone) {
+
+        //The corners of a square stick go past one, so stop there.
+        const double magnitude = std::min(stick.norm(), 1.);
+        if (magnitude < deadzone) {
+
+            return {0, 0};
+        }
+        return stick.normalize() * ((magnitude - deadzone) / (1 - deadzone));
+    }
+    inline double applyDeadzone(const double &value, const double &deadzone) {
+
+        const double magnitude = std::min(fabs(value), 1.);
+        if (magnitude < deadzone) {
+
+            return 0;
+        }
+        return copysign((magnitude - deadzone) / (1 - deadzone), value);
+    }
+    inline double applyExpo(const double &value, const double &expo) {
+
+        return (1 - expo) * value + expo * value * value * value;
+    }
+    inline double getDeadzoneZ(const double &magnitudeXY) {
+
+        return R_deadzoneControllerZ * (1 + R_deadzoneControllerZStrafe * magnitudeXY);
+    }
+    inline bool getInDeadzone(const ControllerState &controller) {
+
+        const Vec2d stick{controller.getAxis(ControllerState::kJoystickX), controller.getAxis(ControllerState::kJoystickY)};
+        return stick.norm() < R_deadzoneController && fabs(controller.getAxis(ControllerState::kJoystickZ)) < R_deadzoneControllerZ;
+    }
+    inline void getFractions(const ControllerState &controller, double &x, double &y, double &z) {
+
+        //The stick's Y is negative when pushed forward.
+        const Vec2d stick{controller.getAxis(ControllerState::kJoystickX), -controller.getAxis(ControllerState::kJoystickY)};
+
+        //To prevent controller drift, the stick counts from the edge of a
+        //round deadzone...
+        const Vec2d translation = applyRadialDeadzone(stick, R_deadzoneController);
+        const double magnitude = translation.norm();
+
+        //And to prevent accidental turning, the twist counts from the edge of
+        //one that grows with how far the stick is pushed.
+        z = applyDeadzone(controller.getAxis(ControllerState::kJoystickZ), getDeadzoneZ(magnitude));
+        z = applyExpo(z, R_inputExpoRotation);
+
+        //Curve the stick's magnitude rather than each axis, so that the
+        //direction it points is the direction Zion goes.
+        if (magnitude > 0) {
+
+            const Vec2d curved = translation * (applyExpo(magnitude, R_inputExpoTranslation) / magnitude);
+            x = curved.i;
+            y = curved.j;
+        }
+        else {
+
+            x = 0;
+            y = 0;
+        }
+    }
+    inline ChassisSpeeds getChassisSpeeds(const ControllerState &controller, const double &executionCap, const double &rotationCap) {
+
+        double x;
+        double y;
+        double z;
+        getFractions(controller, x, y, z);
+        //Limit the Z axis by its cap, as turning can be violent, unless
+        //the execution cap is lower still.
+        return ChassisSpeeds::fromFractions(x * executionCap, y * executionCap, z * std::min(executionCap, rotationCap));
+    }
+
+    class SlewLimiter {
+
+        public:
+            double calculate(const double &value, const double &maxChange) {
+
+                m_value += std::max(-maxChange, std::min(value - m_value, maxChange));
+                return m_value;
+            }
+            void reset(const double &value = 0) {
+
+                m_value = value;
+            }
+
+        private:
+            double m_value = 0;
+    };
+
+    class Shaper {
+
+        public:
+            ChassisSpeeds getChassisSpeeds(const ControllerState &controller, const double &executionCap, const double &rotationCap) {
+
+                double x;
+                double y;
+                double z;
+                getFractions(controller, x, y, z);
+
+                //Slew after the caps, so that a lower cap (like the precision
+                //one) is as quick to respond as the full one.
+                const double maxChange = R_inputSlewRate * R_robotLoopPeriod;
+                x = m_x.calculate(x * executionCap, maxChange);
+                y = m_y.calculate(y * executionCap, maxChange);
+                z = m_z.calculate(z * std::min(executionCap, rotationCap), maxChange);
+                return ChassisSpeeds::fromFractions(x, y, z);
+            }
+            void reset() {
+
+                m_x.reset();
+                m_y.reset();
+                m_z.reset();
+            }
+
+        private:
+            SlewLimiter m_x;
+            SlewLimiter m_y;
+            SlewLimiter m_z;
+    };
+}
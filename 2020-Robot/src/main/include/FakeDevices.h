@@ -0,0 +1,654 @@
+/*
+struct FakeDevices
+
+    The device policy (see Devices.h) of in-memory stand-ins for every motor
+        controller and sensor used on Zion. Each one has the same methods the
+        robot code calls on the real device, but only stores what it is given
+        and returns whatever it was last told to. Nothing here touches CAN,
+        PWM, DIO, or SPI, so the robot classes built on FakeDevices are
+        deterministic and can run anywhere, including on a desktop.
+
+    Only the tests define INCLUDE_FAKE_DEVICES, which is what builds the
+    robot classes on FakeDevices. Nothing else may include this, except
+    Devices.h in the tests, where FAKE_NAVX makes FakeAHRS the NavX of
+    RevDevices too, since there is no NavX library to link on the desktop.
+
+    Every fake registers itself under its port or ID when constructed, so
+    code that did not construct it (a benchmark, a Simulation) can find it
+    again to read its outputs or write its sensor values. A port or ID past
+    what the roboRIO has fails an assert.
+
+class FakeSparkMax
+    Mirrors rev::CANSparkMax. Get() returns the last Set() output.
+    static FakeSparkMax *get(const int&)
+        Returns the fake on the supplied CAN ID, or nullptr.
+    IdleMode getIdleMode()
+        Returns the last idle mode set.
+    void setEncoder(const double&, const double& = 0)
+        Sets the position (rotations) and velocity (RPM) its encoder reports.
+
+    double getVoltageCompensation()
+        Returns the nominal voltage last enabled, or 0 if disabled.
+    int getPeriodicFramePeriod(const PeriodicFrame&)
+        Returns the period, in milliseconds, last set for the supplied status
+        frame, or the SPARK MAX's default.
+
+class FakeSparkMaxEncoder
+    Mirrors rev::CANEncoder, sharing the values of the FakeSparkMax it came
+    from.
+
+class FakeSparkMaxPIDController
+    Mirrors rev::CANPIDController. SetReference() with kDutyCycle is Set();
+    with kVelocity it works out the output the Spark MAX would (feedforward
+    plus proportional on the encoder's velocity, clamped to the output range)
+    once, at the time of the call, rather than continuously.
+    double getReference()
+        Returns the last reference set.
+
+class FakeAHRS
+    Mirrors AHRS (the NavX). GetYaw() is the angle since the last ZeroYaw(),
+    wrapped to -180 to 180.
+    static FakeAHRS *get()
+        Returns the most recently constructed fake, or nullptr.
+    void setAngle(const double&)
+        Sets the continuous angle, in degrees.
+    void setRate(const double&)
+        Sets the rate GetRate() returns, in degrees per second.
+    void setWorldLinearAccel(const double&, const double&)
+        Sets the X and Y accelerations, in g's.
+
+class FakeVictorSP
+class FakeServo
+class FakeDigitalInput
+    Mirror their frc:: counterparts, registered by PWM or DIO channel.
+    static Fake...*get(const int&)
+        Returns the fake on the supplied channel, or nullptr.
+    void set(const bool&)
+        (FakeDigitalInput only) Sets the value Get() returns. If that is an
+        edge interrupts were set up and enabled for, calls the handler from
+        RequestInterrupts() right away, as the FPGA would.
+
+class FakeAnalogInput
+    Mirrors frc::AnalogInput, registered by analog channel.
+    static FakeAnalogInput *get(const int&)
+        Returns the fake on the supplied channel, or nullptr.
+    void setVoltage(const double&)
+        Sets the voltage GetVoltage() returns.
+
+class FakePreferences
+    Mirrors frc::Preferences, kept in memory instead of on the roboRIO.
+    static FakePreferences *GetInstance()
+        Returns the one store, like the real one.
+    void clear()
+        Forgets every key, as if the file had been deleted.
+*/
+
+#pragma once
+
+#include <assert.h>
+#include <math.h>
+
+#include <functional>
+#include <iterator>
+#include <map>
+#include <string>
+
+#include <frc/SPI.h>
+
+class FakeSparkMaxEncoder;
+class FakeSparkMaxPIDController;
+
+enum class FakeControlType {
+
+    kDutyCycle, kVelocity, kVoltage, kPosition
+};
+
+class FakeSparkMax {
+
+    public:
+        enum class MotorType {
+
+            kBrushed = 0, kBrushless = 1
+        };
+        enum class IdleMode {
+
+            kCoast = 0, kBrake = 1
+        };
+        enum class PeriodicFrame {
+
+            kStatus0 = 0, kStatus1 = 1, kStatus2 = 2
+        };
+
+        FakeSparkMax(const int &deviceID, const MotorType &type) {
+
+            m_deviceID = deviceID;
+            m_output = 0;
+            m_idleMode = IdleMode::kBrake;
+            m_position = 0;
+            m_velocity = 0;
+            m_voltageCompensation = 0;
+            m_reference = 0;
+            m_p = 0;
+            m_i = 0;
+            m_d = 0;
+            m_ff = 0;
+            m_minimumOutput = -1;
+            m_maximumOutput = 1;
+            //The SPARK MAX's defaults, in milliseconds.
+            m_framePeriods[0] = 10;
+            m_framePeriods[1] = 20;
+            m_framePeriods[2] = 20;
+            registry(deviceID) = this;
+        }
+        ~FakeSparkMax() {
+
+            if (registry(m_deviceID) == this) {
+
+                registry(m_deviceID) = nullptr;
+            }
+        }
+
+        void Set(const double &speed) {
+
+            m_output = speed;
+        }
+        double Get() const {
+
+            return m_output;
+        }
+        void SetIdleMode(const IdleMode &idleMode) {
+
+            m_idleMode = idleMode;
+        }
+        int GetDeviceId() const {
+
+            return m_deviceID;
+        }
+        void EnableVoltageCompensation(const double &nominalVoltage) {
+
+            m_voltageCompensation = nominalVoltage;
+        }
+        void DisableVoltageCompensation() {
+
+            m_voltageCompensation = 0;
+        }
+        void SetPeriodicFramePeriod(const PeriodicFrame &frame, const int &periodMs) {
+
+            m_framePeriods[(int)frame] = periodMs;
+        }
+        FakeSparkMaxEncoder GetEncoder();
+        FakeSparkMaxPIDController GetPIDController();
+
+        static FakeSparkMax *get(const int &deviceID) {
+
+            return registry(deviceID);
+        }
+        IdleMode getIdleMode() {
+
+            return m_idleMode;
+        }
+        void setEncoder(const double &position, const double &velocity = 0) {
+
+            m_position = position;
+            m_velocity = velocity;
+        }
+        double getVoltageCompensation() {
+
+            return m_voltageCompensation;
+        }
+        int getPeriodicFramePeriod(const PeriodicFrame &frame) {
+
+            return m_framePeriods[(int)frame];
+        }
+
+    private:
+        //There are only 64 CAN IDs.
+        static FakeSparkMax *&registry(const int &deviceID) {
+
+            static FakeSparkMax *devices[64] = {};
+            assert(deviceID >= 0 && deviceID < (int)std::size(devices));
+            return devices[deviceID];
+        }
+
+        int m_deviceID;
+        double m_output;
+        IdleMode m_idleMode;
+        double m_position;
+        double m_velocity;
+        double m_voltageCompensation;
+        int m_framePeriods[3];
+        double m_reference;
+        double m_p;
+        double m_i;
+        double m_d;
+        double m_ff;
+        double m_minimumOutput;
+        double m_maximumOutput;
+
+        friend class FakeSparkMaxEncoder;
+        friend class FakeSparkMaxPIDController;
+};
+
+class FakeSparkMaxEncoder {
+
+    public:
+        explicit FakeSparkMaxEncoder(FakeSparkMax *motor) {
+
+            m_motor = motor;
+        }
+
+        double GetPosition() {
+
+            return m_motor->m_position;
+        }
+        double GetVelocity() {
+
+            return m_motor->m_velocity;
+        }
+        void SetPosition(const double &position) {
+
+            m_motor->m_position = position;
+        }
+
+    private:
+        FakeSparkMax *m_motor;
+};
+
+class FakeSparkMaxPIDController {
+
+    public:
+        explicit FakeSparkMaxPIDController(FakeSparkMax *motor) {
+
+            m_motor = motor;
+        }
+
+        void SetP(const double &gain, const int &slot = 0) {
+
+            m_motor->m_p = gain;
+        }
+        void SetI(const double &gain, const int &slot = 0) {
+
+            m_motor->m_i = gain;
+        }
+        void SetD(const double &gain, const int &slot = 0) {
+
+            m_motor->m_d = gain;
+        }
+        void SetFF(const double &gain, const int &slot = 0) {
+
+            m_motor->m_ff = gain;
+        }
+        void SetOutputRange(const double &minimum, const double &maximum, const int &slot = 0) {
+
+            m_motor->m_minimumOutput = minimum;
+            m_motor->m_maximumOutput = maximum;
+        }
+        void SetReference(const double &reference, const FakeControlType &type, const int &slot = 0, const double &arbitraryFeedforward = 0) {
+
+            m_motor->m_reference = reference;
+            double output = reference;
+            if (type == FakeControlType::kVelocity) {
+
+                output = m_motor->m_ff * reference + m_motor->m_p * (reference - m_motor->m_velocity);
+            }
+            m_motor->m_output = fmin(fmax(output, m_motor->m_minimumOutput), m_motor->m_maximumOutput);
+        }
+
+        double getReference() {
+
+            return m_motor->m_reference;
+        }
+
+    private:
+        FakeSparkMax *m_motor;
+};
+
+inline FakeSparkMaxEncoder FakeSparkMax::GetEncoder() {
+
+    return FakeSparkMaxEncoder(this);
+}
+inline FakeSparkMaxPIDController FakeSparkMax::GetPIDController() {
+
+    return FakeSparkMaxPIDController(this);
+}
+
+class FakeAHRS {
+
+    public:
+        explicit FakeAHRS(const frc::SPI::Port &port) {
+
+            m_angle = 0;
+            m_yawZero = 0;
+            m_rate = 0;
+            m_accelX = 0;
+            m_accelY = 0;
+            instance() = this;
+        }
+        ~FakeAHRS() {
+
+            if (instance() == this) {
+
+                instance() = nullptr;
+            }
+        }
+
+        float GetYaw() {
+
+            return remainder(m_angle - m_yawZero, 360);
+        }
+        double GetAngle() {
+
+            return m_angle;
+        }
+        double GetRate() {
+
+            return m_rate;
+        }
+        float GetWorldLinearAccelX() {
+
+            return m_accelX;
+        }
+        float GetWorldLinearAccelY() {
+
+            return m_accelY;
+        }
+        void ZeroYaw() {
+
+            m_yawZero = m_angle;
+        }
+        void Reset() {
+
+            m_angle = 0;
+            m_yawZero = 0;
+        }
+
+        static FakeAHRS *get() {
+
+            return instance();
+        }
+        void setAngle(const double &angle) {
+
+            m_angle = angle;
+        }
+        void setRate(const double &rate) {
+
+            m_rate = rate;
+        }
+        void setWorldLinearAccel(const double &accelX, const double &accelY) {
+
+            m_accelX = accelX;
+            m_accelY = accelY;
+        }
+
+    private:
+        static FakeAHRS *&instance() {
+
+            static FakeAHRS *gyro = nullptr;
+            return gyro;
+        }
+
+        double m_angle;
+        double m_yawZero;
+        double m_rate;
+        double m_accelX;
+        double m_accelY;
+};
+
+class FakeVictorSP {
+
+    public:
+        explicit FakeVictorSP(const int &channel) {
+
+            m_channel = channel;
+            m_output = 0;
+            registry(channel) = this;
+        }
+        ~FakeVictorSP() {
+
+            if (registry(m_channel) == this) {
+
+                registry(m_channel) = nullptr;
+            }
+        }
+
+        void Set(const double &speed) {
+
+            m_output = speed;
+        }
+        double Get() const {
+
+            return m_output;
+        }
+
+        static FakeVictorSP *get(const int &channel) {
+
+            return registry(channel);
+        }
+
+    private:
+        //The roboRIO has 10 PWM headers and 10 more on the MXP.
+        static FakeVictorSP *&registry(const int &channel) {
+
+            static FakeVictorSP *devices[20] = {};
+            assert(channel >= 0 && channel < (int)std::size(devices));
+            return devices[channel];
+        }
+
+        int m_channel;
+        double m_output;
+};
+
+class FakeServo {
+
+    public:
+        explicit FakeServo(const int &channel) {
+
+            m_channel = channel;
+            m_angle = 0;
+            registry(channel) = this;
+        }
+        ~FakeServo() {
+
+            if (registry(m_channel) == this) {
+
+                registry(m_channel) = nullptr;
+            }
+        }
+
+        void SetAngle(const double &angle) {
+
+            m_angle = angle;
+        }
+        double GetAngle() const {
+
+            return m_angle;
+        }
+
+        static FakeServo *get(const int &channel) {
+
+            return registry(channel);
+        }
+
+    private:
+        static FakeServo *&registry(const int &channel) {
+
+            static FakeServo *devices[20] = {};
+            assert(channel >= 0 && channel < (int)std::size(devices));
+            return devices[channel];
+        }
+
+        int m_channel;
+        double m_angle;
+};
+
+class FakeDigitalInput {
+
+    public:
+        explicit FakeDigitalInput(const int &channel) {
+
+            m_channel = channel;
+            //Nothing is wired in, so the pull-up reads high.
+            m_value = true;
+            registry(channel) = this;
+        }
+        ~FakeDigitalInput() {
+
+            if (registry(m_channel) == this) {
+
+                registry(m_channel) = nullptr;
+            }
+        }
+
+        bool Get() const {
+
+            return m_value;
+        }
+        int GetChannel() const {
+
+            return m_channel;
+        }
+
+        enum WaitResult {
+
+            kTimeout = 0x0, kRisingEdge = 0x1, kFallingEdge = 0x100, kBoth = 0x101
+        };
+        void RequestInterrupts(std::function<void(WaitResult)> handler) {
+
+            m_handler = handler;
+        }
+        void SetUpSourceEdge(const bool &risingEdge, const bool &fallingEdge) {
+
+            m_risingEdge = risingEdge;
+            m_fallingEdge = fallingEdge;
+        }
+        void EnableInterrupts() {
+
+            m_interruptsEnabled = true;
+        }
+
+        static FakeDigitalInput *get(const int &channel) {
+
+            return registry(channel);
+        }
+        void set(const bool &value) {
+
+            const bool rising = value && !m_value;
+            const bool falling = !value && m_value;
+            m_value = value;
+            if (m_interruptsEnabled && m_handler && ((rising && m_risingEdge) || (falling && m_fallingEdge))) {
+
+                m_handler(rising ? kRisingEdge : kFallingEdge);
+            }
+        }
+
+    private:
+        //The roboRIO has 10 DIO headers and 16 more on the MXP.
+        static FakeDigitalInput *&registry(const int &channel) {
+
+            static FakeDigitalInput *devices[26] = {};
+            assert(channel >= 0 && channel < (int)std::size(devices));
+            return devices[channel];
+        }
+
+        int m_channel;
+        bool m_value;
+        std::function<void(WaitResult)> m_handler;
+        bool m_risingEdge = true;
+        bool m_fallingEdge = false;
+        bool m_interruptsEnabled = false;
+};
+
+class FakeAnalogInput {
+
+    public:
+        explicit FakeAnalogInput(const int &channel) {
+
+            m_channel = channel;
+            m_voltage = 0;
+            registry(channel) = this;
+        }
+        ~FakeAnalogInput() {
+
+            if (registry(m_channel) == this) {
+
+                registry(m_channel) = nullptr;
+            }
+        }
+
+        double GetVoltage() const {
+
+            return m_voltage;
+        }
+        int GetChannel() const {
+
+            return m_channel;
+        }
+
+        static FakeAnalogInput *get(const int &channel) {
+
+            return registry(channel);
+        }
+        void setVoltage(const double &voltage) {
+
+            m_voltage = voltage;
+        }
+
+    private:
+        //The roboRIO has 4 analog inputs and 4 more on the MXP.
+        static FakeAnalogInput *&registry(const int &channel) {
+
+            static FakeAnalogInput *devices[8] = {};
+            assert(channel >= 0 && channel < (int)std::size(devices));
+            return devices[channel];
+        }
+
+        int m_channel;
+        double m_voltage;
+};
+
+class FakePreferences {
+
+    public:
+        static FakePreferences *GetInstance() {
+
+            static FakePreferences preferences;
+            return &preferences;
+        }
+
+        bool ContainsKey(const std::string &key) const {
+
+            return m_values.count(key) != 0;
+        }
+        double GetDouble(const std::string &key, const double &defaultValue = 0) const {
+
+            const auto value = m_values.find(key);
+            return value == m_values.end() ? defaultValue : value->second;
+        }
+        void PutDouble(const std::string &key, const double &value) {
+
+            m_values[key] = value;
+        }
+        void clear() {
+
+            m_values.clear();
+        }
+
+    private:
+        FakePreferences() {}
+
+        std::map<std::string, double> m_values;
+};
+
+struct FakeDevices {
+
+    using SparkMax = FakeSparkMax;
+    using SparkMaxEncoder = FakeSparkMaxEncoder;
+    using SparkMaxPIDController = FakeSparkMaxPIDController;
+    using ControlType = FakeControlType;
+    using Gyro = FakeAHRS;
+    using VictorSP = FakeVictorSP;
+    using Servo = FakeServo;
+    using DigitalInput = FakeDigitalInput;
+    using AnalogInput = FakeAnalogInput;
+    using Preferences = FakePreferences;
+};
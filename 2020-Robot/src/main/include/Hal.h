@@ -1,5 +1,7 @@
 /*
-class HAL
+class BasicHal<Devices>
+
+    Usually used as Hal, which is built on RevDevices. See Devices.h.
 
 Allows low-level automatic control of the robot as a secondary driver. The
     whole class is really just a conglomarate wrapper for auto functionality.
@@ -23,7 +25,7 @@ Allows low-level automatic control of the robot as a secondary driver. The
 
 Constructors
 
-    HAL(Intake&, Launcher&, Limelight&, NavX&, SwerveTrain&)
+    BasicHal(BasicIntake&, BasicLauncher&, Limelight&, BasicNavX&, BasicSwerveTrain&)
         Creates an autonomous driver with access to everything necessary
         for autonomous operation on the robot.
 
@@ -36,21 +38,28 @@ Public Methods
         back to original direction. This system allows precise movement in
         setting the swerves to one position and then moving back and forth
         between them without swerve wobble, such as when lining up laterally
-        with the high goal.
+        with the high goal. The swerves are turned by submitting kPoint
+        commands to the swerve train, which returns true once it reports
+        them there (see BasicSwerveTrain::getPointed()).
     bool zionAssumeDistance(const double&)
         Uses the supplied distance to move that far in whatever direction
         the swerves are currently set for. As such, the usual order is a
         zionAssumeDirection followed by this. Zero speed is set once the
         distance is achieved; distance measured by the circumference of a
-        wheel.
+        wheel. Drives by submitting Hal's commands to the swerve train (see
+        BasicSwerveTrain::submit()), relative to the robot, and stops dead
+        at the distance.
     bool zionAssumeRotationDegrees(const double&)
         Rotates the desired number of degrees using the NavX sensor. Does
-        so at a constant global speed; could likely be regressed similarly
-        to the swerve modules. Returns to zero position when done.
-    void zionShootingPositionToTrenchGrab()
+        so at a constant global speed through BasicSwerveTrain::submit();
+        could likely be regressed similarly to the swerve modules. Returns
+        to zero position when done, with kStraighten commands, over as many
+        calls as that takes.
+    bool zionShootingPositionToTrenchGrab()
         Moves laterally and rotationally from the auto shooting position
         in front of the high goal through the trench to pick up more
         Power Cells. Actuates the intake appropriately in the process.
+        Returns true once it has.
     void zionTrenchGrabToShootingPosition()
         Same as above, but minus the intake and the exact opposite
         movements, with more launching.
@@ -61,28 +70,32 @@ Public Methods
 
 Private Methods
 
-    void setZionMotorsToVector(const VectorDouble &)
-        Sets the swerve positions on Zion to the angle of the passed vector
-        inscribed in standard position. Used to assume directions by vector.
-        This makes for easy, accurate, and actually sensible positioning, as
-        the vectors to move in cardinal directions are just the signed
-        cartesian axes.
+    ChassisSpeeds getDirectionSpeeds()
+        Returns the speeds, relative to the robot, to move in the direction
+        last assumed by zionAssumeDirection(). Used both to point the swerves
+        that way and to drive that way. The directions are vectors, as the
+        vectors to move in cardinal directions are just the signed cartesian
+        axes.
 */
 
 #include <math.h>
 
+#include "ChassisSpeeds.h"
+#include "Devices.h"
+#include "DriveCommand.h"
 #include "Intake.h"
 #include "Launcher.h"
 #include "Limelight.h"
 #include "NavX.h"
 #include "RobotMap.h"
 #include "SwerveTrain.h"
-#include "VectorDouble.h"
+#include "Vec2.h"
 
-class Hal {
+template <class Devices>
+class BasicHal {
 
     public:
-        Hal(Intake &refIntake, Launcher &refLauncher, Limelight &refLimelight, NavX &refNavX, SwerveTrain &refZion) {
+        BasicHal(BasicIntake<Devices> &refIntake, BasicLauncher<Devices> &refLauncher, Limelight &refLimelight, BasicNavX<Devices> &refNavX, BasicSwerveTrain<Devices> &refZion) {
 
             m_intake = &refIntake;
             m_launcher = &refLauncher;
@@ -93,66 +106,38 @@ class Hal {
             m_utilityVarsSet = false;
             m_utilityVarOne = 0;
             m_utilityVarTwo = 0;
+            m_routineStep = 0;
         }
 
         //TODO: DOCUMENT ME
         bool zionAssumeDirection(const int &directionToMove) {
 
             //TODO: Why inverted?
-            VectorDouble right(-1,0);
-            VectorDouble backward(0,1);
-            VectorDouble left(1,0);
-            //Since all wheels are turning very close to the same distance,
-            //grab the beginning and end of one of them for use in checking
-            //when positioning is complete once at the beginning of the loop
+            constexpr Vec2d right{-1, 0};
+            constexpr Vec2d backward{0, 1};
+            constexpr Vec2d left{1, 0};
+            //At the first iteration, remember when we started, so that only
+            //pointing asked for since then counts, and the direction for
+            //zionAssumeDistance(). Forward is the zero position, which is
+            //straight up.
             if (!m_utilityVarsSet) {
 
-                m_utilityVarOne = m_zion->m_frontRight->getSwervePosition();
-                m_utilityVarTwo = m_zion->getClockwiseREVRotationsFromCenter(directionToMove == Hal::ZionDirections::kBackward ? backward : directionToMove == Hal::ZionDirections::kLeft ? left : right);
+                m_utilityVarOne = DriveCommand::now();
                 m_utilityVarsSet = true;
+                m_direction = directionToMove == ZionDirections::kForward ? Vec2d{0, 1} : directionToMove == ZionDirections::kBackward ? backward : directionToMove == ZionDirections::kLeft ? left : right;
             }
 
-            switch (directionToMove) {
-
-                case kForward: m_zion->assumeNearestZeroPosition(); break;
-                case kRight: setZionMotorsToVector(right); break;
-                case kBackward: setZionMotorsToVector(backward); break;
-                case kLeft: setZionMotorsToVector(left); break;
-            }
-
-            if (directionToMove != ZionDirections::kForward) {
+            //The swerve train turns the swerves itself, from its own thread,
+            //for as long as we keep asking...
+            m_zion->submit(DriveCommand::pointFromSource(DriveCommand::kHal, getDirectionSpeeds()));
+            //And says when they are there.
+            if (m_zion->getPointed(m_utilityVarOne)) {
 
-                if (m_utilityVarOne + m_utilityVarTwo - m_zion->m_frontRight->getSwervePosition() < .25) {
-
-                    m_zion->m_frontRight->setSwerveSpeed();
-                    m_zion->m_frontLeft->setSwerveSpeed();
-                    m_zion->m_rearLeft->setSwerveSpeed();
-                    m_zion->m_rearRight->setSwerveSpeed();
-                    m_utilityVarOne = 0;
-                    m_utilityVarTwo = 0;
-                    m_utilityVarsSet = false;
-                    return true;
-                }
-                else {
-
-                    return false;
-                }
-            }
-            if ((m_zion->m_frontRight->getSwervePosition() - m_zion->m_frontRight->getSwerveZeroPosition()) < .1 && (m_zion->m_frontLeft->getSwervePosition() - m_zion->m_frontLeft->getSwerveZeroPosition()) < .1 && (m_zion->m_rearLeft->getSwervePosition() - m_zion->m_rearLeft->getSwerveZeroPosition()) < .1 && (m_zion->m_rearRight->getSwervePosition() - m_zion->m_rearRight->getSwerveZeroPosition()) < .1) {
-
-                m_zion->m_frontRight->setSwerveSpeed();
-                m_zion->m_frontLeft->setSwerveSpeed();
-                m_zion->m_rearLeft->setSwerveSpeed();
-                m_zion->m_rearRight->setSwerveSpeed();
                 m_utilityVarOne = 0;
-                m_utilityVarTwo = 0;
                 m_utilityVarsSet = false;
                 return true;
             }
-            else {
-
-                return false;
-            }
+            return false;
         }
         bool zionAssumeDistance(const double &distanceToMove) {
 
@@ -174,13 +159,15 @@ class Hal {
             //used as a tolerance)...
             if (m_utilityVarTwo - m_zion->m_frontRight->getDrivePosition() > 0) {
 
-                m_zion->setDriveSpeed(R_zionAutoMovementSpeedLateral);
+                //Drive relative to the robot in the direction the swerves
+                //were set to, which holds them there.
+                m_zion->submit(DriveCommand::fromSource(DriveCommand::kHal, getDirectionSpeeds(), false));
             }
             //If we were...
             else {
 
                 //Stop moving, clean up, and return true.
-                m_zion->setDriveSpeed();
+                m_zion->submit(DriveCommand::stopFromSource(DriveCommand::kHal));
                 m_utilityVarsSet = false;
                 m_utilityVarOne = 0;
                 m_utilityVarTwo = 0;
@@ -192,41 +179,36 @@ class Hal {
         }
         bool zionAssumeRotationDegrees(const double &degreesToRotate) {
 
-            //At the first iteration, set the starting and goal angles to
-            //memory for comparison once operating...
+            //At the first iteration, set the goal angle to memory for
+            //comparison once operating...
             if (!m_utilityVarsSet) {
 
-                m_utilityVarOne = m_navX->getAngle();
-                m_utilityVarTwo = m_utilityVarOne + degreesToRotate;
+                m_utilityVarOne = m_navX->getAngle() + degreesToRotate;
+                m_utilityVarTwo = 0;
                 m_utilityVarsSet = true;
             }
 
-            //Set the wheels to their diagonal positions (at incremental 45*
-            //angles found with radians converted into Nics). This works as
-            //this section of the code also runs as a loop, and these functions
-            //handle setting values down to zero once correct...
-            m_zion->m_frontRight->assumeSwervePosition((1.0 / 8.0) * R_nicsConstant);
-            m_zion->m_frontLeft->assumeSwervePosition((3.0 / 8.0) * R_nicsConstant);
-            m_zion->m_rearLeft->assumeSwervePosition((5.0 / 8.0) * R_nicsConstant);
-            m_zion->m_rearRight->assumeSwervePosition((7.0 / 8.0) * R_nicsConstant);
-
-            //If we're not within tolerance for meeting the goal angle...
-            if (abs(m_utilityVarTwo - m_navX->getAngle()) > R_zionAutoToleranceAngle) {
-
-                //If rotation needs to be clockwise (goal is greater than init)
-                //set the turning speed to be positive, otherise, set it
-                //negative (due to the way the wheels align, these values are
-                //inverted)...
-                m_zion->setDriveSpeed(m_utilityVarTwo > m_utilityVarOne ? -R_zionAutoMovementSpeedLateral : R_zionAutoMovementSpeedLateral);
+            //If we're not within tolerance for meeting the goal angle, and
+            //haven't been yet...
+            if (m_utilityVarTwo == 0 && fabs(m_utilityVarOne - m_navX->getAngle()) > R_zionAutoToleranceAngle) {
+
+                //Turn in place. The NavX counts counterclockwise, so if the
+                //goal is greater than init, turn counterclockwise (positive),
+                //otherwise clockwise. The kinematics set the wheels to their
+                //diagonal positions on the way...
+                m_zion->submit(DriveCommand::fromSource(DriveCommand::kHal, ChassisSpeeds::fromFractions(0, 0, degreesToRotate > 0 ? R_zionAutoMovementSpeedLateral : -R_zionAutoMovementSpeedLateral), false));
+                return false;
             }
-            //If we were within tolerance that iteration...
-            else {
+            //If we were, stop dead and reset the wheels, which takes a few
+            //more iterations, so remember when that started...
+            if (m_utilityVarTwo == 0) {
+
+                m_utilityVarTwo = DriveCommand::now();
+            }
+            m_zion->submit(DriveCommand::fromAction(DriveCommand::kHal, DriveCommand::kStraighten));
+            //And once they are reset, clean up and return true.
+            if (m_zion->getPointed(m_utilityVarTwo)) {
 
-                //Stop moving, reset the wheels, clean up, and return true.
-                m_zion->setDriveSpeed();
-                //Since this is a core auto function, it must be run as
-                //a loop, so do so and then continue with the rest of cleanup.
-                while (!zionAssumeDirection(ZionDirections::kForward));
                 m_utilityVarsSet = false;
                 m_utilityVarOne = 0;
                 m_utilityVarTwo = 0;
@@ -246,36 +228,37 @@ class Hal {
             //Movement forward into the trench.
             double distanceForward = 60;
 
-            //Perform each step of the process wih a utilityVar so each
-            //step only occurs once and in order. Evaluate the utilityVar
+            //Perform each step of the process wih a step counter so each
+            //step only occurs once and in order. It is not a utilityVar, as
+            //the steps use those themselves. Evaluate the step counter
             //first so that the functions only run when necessary and as order
             //necessitates, as && is a short-circuiting operator. Thus, if it
             //is not a function's turn to run, it does not run, and if it is,
             //it is the only one that runs.
             //Rotate 90* to line up the intake to the trench. TODO: Which direction?
-            if (m_utilityVarOne == 0 && zionAssumeRotationDegrees(90)) {
+            if (m_routineStep == 0 && zionAssumeRotationDegrees(90)) {
 
-                m_utilityVarOne = 1;
+                m_routineStep = 1;
             }
             //Move left the appropriate distance.
-            if (m_utilityVarOne == 1 && zionAssumeDirection(ZionDirections::kLeft)) {
+            if (m_routineStep == 1 && zionAssumeDirection(ZionDirections::kLeft)) {
 
-                m_utilityVarOne = 2;
+                m_routineStep = 2;
             }
-            if (m_utilityVarOne == 2 && zionAssumeDistance(distanceLeft)) {
+            if (m_routineStep == 2 && zionAssumeDistance(distanceLeft)) {
 
-                m_utilityVarOne = 3;
+                m_routineStep = 3;
             }
             //Same for forward.
-            if (m_utilityVarOne == 3 && zionAssumeDirection(ZionDirections::kForward)) {
+            if (m_routineStep == 3 && zionAssumeDirection(ZionDirections::kForward)) {
 
-                m_utilityVarOne = 4;
+                m_routineStep = 4;
             }
-            if (m_utilityVarOne == 4 && zionAssumeDistance(distanceForward)) {
+            if (m_routineStep == 4 && zionAssumeDistance(distanceForward)) {
 
                 //This is the last step, so if it was successful, clean up and
                 //return true.
-                m_utilityVarOne = 0;
+                m_routineStep = 0;
                 return true;
             }
             //If we've made it here, some step of the process failed, so return
@@ -302,21 +285,24 @@ class Hal {
         };
 
     private:
-        void setZionMotorsToVector(const VectorDouble &vectorToSet) {
+        ChassisSpeeds getDirectionSpeeds() {
 
-            m_zion->m_frontRight->assumeSwervePosition(m_zion->getClockwiseREVRotationsFromCenter(vectorToSet));
-            m_zion->m_frontLeft->assumeSwervePosition(m_zion->getClockwiseREVRotationsFromCenter(vectorToSet));
-            m_zion->m_rearLeft->assumeSwervePosition(m_zion->getClockwiseREVRotationsFromCenter(vectorToSet));
-            m_zion->m_rearRight->assumeSwervePosition(m_zion->getClockwiseREVRotationsFromCenter(vectorToSet));
+            //The direction vectors have X inverted like the kinematics, so
+            //flip it back.
+            return ChassisSpeeds::fromFractions(-m_direction.i * R_zionAutoMovementSpeedLateral, m_direction.j * R_zionAutoMovementSpeedLateral, 0);
         }
 
-        Intake *m_intake;
-        Launcher *m_launcher;
+        BasicIntake<Devices> *m_intake;
+        BasicLauncher<Devices> *m_launcher;
         Limelight *m_limelight;
-        NavX *m_navX;
-        SwerveTrain *m_zion;
+        BasicNavX<Devices> *m_navX;
+        BasicSwerveTrain<Devices> *m_zion;
+
+        //The direction last assumed by zionAssumeDirection(), for
+        //zionAssumeDistance() to drive in.
+        Vec2d m_direction{0, 1};
 
-        double m_circumferenceWheel = 4 * M_PI;
+        double m_circumferenceWheel = R_zionWheelDiameter * M_PI;
 
         //These are used by the function for values which need to persist
         //across multiple operating calls of the function. What they are is
@@ -324,8 +310,12 @@ class Hal {
         bool m_utilityVarsSet;
         double m_utilityVarOne;
         double m_utilityVarTwo;
+        //Which step of a routine made of the functions above is running.
+        int m_routineStep;
 };
 
+using Hal = BasicHal<RevDevices>;
+
 //TODO: Rewrite for new Limelight distance implement
 /*
     void zionLineupToTarget(const double&, const double&, const double&, const double&)
@@ -1,5 +1,7 @@
 /*
-class Intake
+class BasicIntake<Devices>
+
+    Usually used as Intake, which is built on RevDevices. See Devices.h.
 
 Constructors
 
@@ -15,14 +17,15 @@ Public Methods
 
 #pragma once
 
-#include "rev/CANSparkMax.h"
+#include "Devices.h"
 
-class Intake {
+template <class Devices>
+class BasicIntake {
 
     public:
-        Intake(const int &intakeMotorCANID) {
+        BasicIntake(const int &intakeMotorCANID) {
 
-            m_intakeMotor = new rev::CANSparkMax(intakeMotorCANID, rev::CANSparkMax::MotorType::kBrushed);
+            m_intakeMotor = new typename Devices::SparkMax(intakeMotorCANID, Devices::SparkMax::MotorType::kBrushed);
         }
 
         void setSpeed(const double &speedToSet = 0) {
@@ -31,5 +34,7 @@ class Intake {
         }
 
     private:
-        rev::CANSparkMax *m_intakeMotor;
+        typename Devices::SparkMax *m_intakeMotor;
 };
+
+using Intake = BasicIntake<RevDevices>;
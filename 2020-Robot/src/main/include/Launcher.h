@@ -1,5 +1,7 @@
 /*
-class Launcher
+class BasicLauncher<Devices>
+
+    Usually used as Launcher, which is built on RevDevices. See Devices.h.
 
 Constructors
 
@@ -19,16 +21,18 @@ Public Methods
 
 #pragma once
 
-#include <rev/CANSparkMax.h>
+#include "Devices.h"
+#include "RobotMap.h"
 
-class Launcher {
+template <class Devices>
+class BasicLauncher {
 
     public:
-        Launcher(const int &indexMotorCANID, const int &launchMotorOneCANID, const int &launchMotorTwoCANID) {
+        BasicLauncher(const int &indexMotorCANID, const int &launchMotorOneCANID, const int &launchMotorTwoCANID) {
 
-            indexMotor = new rev::CANSparkMax(indexMotorCANID, rev::CANSparkMax::MotorType::kBrushed);
-            launchMotorOne = new rev::CANSparkMax(launchMotorOneCANID, rev::CANSparkMax::MotorType::kBrushless);
-            launchMotorTwo = new rev::CANSparkMax(launchMotorTwoCANID, rev::CANSparkMax::MotorType::kBrushless);
+            indexMotor = new typename Devices::SparkMax(indexMotorCANID, Devices::SparkMax::MotorType::kBrushed);
+            launchMotorOne = new typename Devices::SparkMax(launchMotorOneCANID, Devices::SparkMax::MotorType::kBrushless);
+            launchMotorTwo = new typename Devices::SparkMax(launchMotorTwoCANID, Devices::SparkMax::MotorType::kBrushless);
         }
 
         void setIndexSpeed(const double &speedToSet = 0) {
@@ -49,7 +53,9 @@ class Launcher {
         }
 
     private:
-        rev::CANSparkMax *indexMotor;
-        rev::CANSparkMax *launchMotorOne;
-        rev::CANSparkMax *launchMotorTwo;
+        typename Devices::SparkMax *indexMotor;
+        typename Devices::SparkMax *launchMotorOne;
+        typename Devices::SparkMax *launchMotorTwo;
 };
+
+using Launcher = BasicLauncher<RevDevices>;
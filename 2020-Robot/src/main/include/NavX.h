@@ -1,5 +1,7 @@
 /*
-class NavX
+class BasicNavX<Devices>
+
+    Usually used as NavX, which is built on RevDevices. See Devices.h.
 
 Constructors
 
@@ -17,6 +19,23 @@ Public Methods
         Returns the angle value (-infinity to infinity, beginning at 0).
     double getAbsoluteAngle()
         Returns the absolute value of the angle value.
+    double getRate()
+        Returns how fast the angle is changing, in degrees per second, with
+        the bias taken out.
+    double getBias()
+        Returns the estimated bias of the NavX, in degrees per second.
+    Note that the yaw and angle returned by the get functions have the
+        NavX's drift, as worked out by updateBias(), taken out.
+    void updateBias(const bool&)
+        Called every loop with whether the wheels say Zion is still. Once it
+        has been still for R_navXStationaryLoops, by the wheels and by the
+        NavX's own accelerometer, any turn the NavX reports is drift, so it
+        is taken out of the heading and averaged into the bias. Otherwise,
+        the bias is taken out instead. Either way, field oriented driving
+        stays pointed the same way for the whole match. Rates are over the
+        time that really passed since the last call, by the FPGA, and a
+        call that missed its deadline (see R_schedulerDeadlineTolerance),
+        like the first after a Wait() in auto, is not learned from.
     void resetYaw()
         Sets the yaw value to zero.
     void resetAll()
@@ -30,30 +49,43 @@ Public Methods
 
 #include <math.h>
 
-#include "AHRS.h"
+#include <atomic>
+
+#include <frc/SPI.h>
+#include <frc/Timer.h>
 
-class NavX {
+#include "Devices.h"
+#include "RobotMap.h"
+
+template <class Devices>
+class BasicNavX {
 
     public:
-        NavX(const int &connectionType) {
+        BasicNavX(const int &connectionType) {
 
             if (connectionType == kUSB) {
 
-                navX = new AHRS(SPI::kOnboardCS0);
+                navX = new typename Devices::Gyro(frc::SPI::kOnboardCS0);
             }
             else if (connectionType == kMXP) {
 
-                navX = new AHRS(SPI::kMXP);
+                navX = new typename Devices::Gyro(frc::SPI::kMXP);
             }
             else {
 
-                navX = new AHRS(SPI::kMXP);
+                navX = new typename Devices::Gyro(frc::SPI::kMXP);
             }
+            m_lastAngle = navX->GetAngle();
+            m_lastTime = frc::Timer::GetFPGATimestamp();
+            m_yawDrift = 0;
+            m_angleDrift = 0;
+            m_bias = 0;
+            m_stationaryLoops = 0;
         }
 
         double getYaw() {
 
-            return navX->GetYaw();
+            return remainder(navX->GetYaw() - m_yawDrift, 360);
         }
         double getYawFull(){
 
@@ -68,20 +100,83 @@ class NavX {
         }
         double getAngle() {
 
-            return navX->GetAngle();
+            return navX->GetAngle() - m_angleDrift;
         }
         double getAbsoluteAngle() {
 
-            return abs(navX->GetAngle());
+            return abs(getAngle());
+        }
+        double getRate() {
+
+            return navX->GetRate() - m_bias;
+        }
+        double getBias() {
+
+            return m_bias;
+        }
+
+        void updateBias(const bool &stationary) {
+
+            const double angle = navX->GetAngle();
+            const double change = angle - m_lastAngle;
+            m_lastAngle = angle;
+            const double time = frc::Timer::GetFPGATimestamp();
+            const double period = time - m_lastTime;
+            m_lastTime = time;
+
+            //If the loop was held up (or ran twice in a row), the change is
+            //not over one loop, and Zion may not have been still for all of
+            //it, so only take the bias out of it.
+            if (fabs(period - R_robotLoopPeriod) > R_schedulerDeadlineTolerance * R_robotLoopPeriod) {
+
+                m_yawDrift = m_yawDrift + m_bias * period;
+                m_angleDrift = m_angleDrift + m_bias * period;
+                return;
+            }
+
+            //Zion is only still if the NavX agrees with the wheels, so that
+            //being shoved while they are locked does not count...
+            if (stationary && fabs(navX->GetWorldLinearAccelX()) < R_navXStationaryMaxAcceleration && fabs(navX->GetWorldLinearAccelY()) < R_navXStationaryMaxAcceleration) {
+
+                m_stationaryLoops++;
+            }
+            else {
+
+                m_stationaryLoops = 0;
+            }
+            //And once it has been for long enough, whatever the NavX turned
+            //through was drift. Take it out, and learn the bias from it...
+            double drift = 0;
+            if (m_stationaryLoops > R_navXStationaryLoops) {
+
+                drift = change;
+                m_bias = m_bias + R_navXBiasFilter * (change / period - m_bias);
+            }
+            //Otherwise, the bias is the best guess of how much of the turn
+            //was drift.
+            else {
+
+                drift = m_bias * period;
+            }
+            m_yawDrift = m_yawDrift + drift;
+            m_angleDrift = m_angleDrift + drift;
         }
 
         void resetYaw() {
 
+            //The yaw starts again from here, and the NavX may jump while it
+            //does, so do not trust it to be still until it has settled.
             navX->ZeroYaw();
+            m_yawDrift = 0;
+            m_stationaryLoops = 0;
         }
         void resetAll() {
 
             navX->Reset();
+            m_yawDrift = 0;
+            m_angleDrift = 0;
+            m_bias = 0;
+            m_stationaryLoops = 0;
         }
 
         enum ConnectionType {
@@ -91,5 +186,16 @@ class NavX {
         };
 
     private:
-        AHRS *navX;
+        typename Devices::Gyro *navX;
+
+        double m_lastAngle;
+        double m_lastTime;
+        //The drivetrain reads the heading from its own thread while the
+        //main loop learns the drift.
+        std::atomic<double> m_yawDrift;
+        std::atomic<double> m_angleDrift;
+        std::atomic<double> m_bias;
+        int m_stationaryLoops;
 };
+
+using NavX = BasicNavX<RevDevices>;
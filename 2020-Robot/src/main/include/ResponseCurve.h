@@ -0,0 +1,127 @@
+/*
+class ResponseCurve<Size>
+
+    A tuned response curve (anything that turns one number into another, like
+        a speed for a distance or an output for a joystick axis) worked out
+        ahead of time into a table of Size evenly spaced points, so that using
+        it costs one lookup and one linear interpolation instead of whatever
+        expensive math (usually exp() or pow()) defines it. Everything is
+        constexpr, so the table is built by the compiler from the current
+        RobotMap constants every time the code is built, and never has to be
+        regenerated by hand.
+
+    The error of linear interpolation is at its largest partway between two
+    points, so getMaxError() checks the middle of every interval. Put it in a
+    static_assert with the largest error the curve's user can accept, and the
+    build fails if a change to the curve or its constants ever makes the
+    table too coarse.
+
+Constructors
+
+    ResponseCurve(Function, const double&, const double&)
+        Builds the table by calling the supplied constexpr function at Size
+        evenly spaced points from the supplied minimum to maximum.
+
+Public Methods
+
+    double getValue(const double&)
+        Returns the curve at the supplied point, interpolated from the table.
+        Points outside of the table are clamped to its ends.
+    bool contains(const double&)
+        Returns true if the supplied point is within the table, so that
+        callers can work out points beyond it some other way.
+    double getMaxError(Function)
+        Returns the largest difference between the table and the supplied
+        function (which should be the one it was built from) at the middle of
+        any interval.
+
+Functions
+
+    double constexprExp(const double&)
+        Returns e to the supplied power, like exp(), but can be used at
+        compile time to build tables. It is accurate to a few ULPs, and far
+        too slow to use at runtime.
+*/
+
+#pragma once
+
+#include <math.h>
+
+constexpr double constexprExp(const double &power) {
+
+    //Split the power into a whole number of ln(2)s and a remainder of at
+    //most half of one, where the Taylor series converges quickly...
+    const int halvings = (int)(power / M_LN2 + (power < 0 ? -.5 : .5));
+    const double remainder = power - halvings * M_LN2;
+    double term = 1;
+    double sum = 1;
+    for (int order = 1; order < 20; order++) {
+
+        term *= remainder / order;
+        sum += term;
+    }
+    //And put the powers of two back.
+    for (int halving = 0; halving < halvings; halving++) {sum *= 2;}
+    for (int halving = 0; halving > halvings; halving--) {sum /= 2;}
+    return sum;
+}
+
+template <int Size>
+class ResponseCurve {
+
+    static_assert(Size >= 2, "A ResponseCurve needs at least both of its ends.");
+
+    public:
+        template <typename Function>
+        constexpr ResponseCurve(Function function, const double &minimum, const double &maximum) :
+
+            m_minimum(minimum),
+            m_maximum(maximum),
+            m_pointsPerUnit((Size - 1) / (maximum - minimum)),
+            m_table{}
+        {
+
+            for (int point = 0; point < Size; point++) {
+
+                m_table[point] = function(minimum + point / m_pointsPerUnit);
+            }
+        }
+
+        constexpr double getValue(const double &x) const {
+
+            const double position = (x - m_minimum) * m_pointsPerUnit;
+            if (position <= 0) {
+
+                return m_table[0];
+            }
+            if (position >= Size - 1) {
+
+                return m_table[Size - 1];
+            }
+            const int index = (int)position;
+            const double fraction = position - index;
+            return m_table[index] + fraction * (m_table[index + 1] - m_table[index]);
+        }
+        constexpr bool contains(const double &x) const {
+
+            return x >= m_minimum && x <= m_maximum;
+        }
+        template <typename Function>
+        constexpr double getMaxError(Function function) const {
+
+            double maxError = 0;
+            for (int point = 0; point < Size - 1; point++) {
+
+                const double middle = m_minimum + (point + .5) / m_pointsPerUnit;
+                const double error = getValue(middle) - function(middle);
+                maxError = error > maxError ? error : -error > maxError ? -error : maxError;
+            }
+            return maxError;
+        }
+
+    private:
+        double m_minimum;
+        double m_maximum;
+        double m_pointsPerUnit;
+        double m_table[Size];
+};
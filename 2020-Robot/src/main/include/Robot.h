@@ -5,6 +5,9 @@
 #include <frc/smartdashboard/SendableChooser.h>
 #include <frc/TimedRobot.h>
 
+#include "ControlLayers.h"
+#include "Controllers.h"
+
 class Robot : public frc::TimedRobot {
 
     public:
@@ -14,21 +17,21 @@ class Robot : public frc::TimedRobot {
         void AutonomousPeriodic() override;
         void TeleopInit() override;
         void TeleopPeriodic() override;
+        void TestPeriodic() override;
         void DisabledPeriodic() override;
 
     private:
         frc::SendableChooser<std::string> *m_chooserAuto;
         std::string m_chooserAutoSelected;
 
-        //These are used such that each speed is only set once for P2.
-        //Prevents weird assignment bugs with motor speeds.
-        bool m_booleanClimberLock;
-        double m_speedClimberClimb;
-        double m_speedClimberTranslate;
-        double m_speedClimberWheel;
-        double m_speedIntake;
-        double m_speedLauncherIndex;
-        double m_speedLauncherLaunch;
+        //These are what P2's control layers set, each only once a loop
+        //by whichever layer owns it. Prevents weird assignment bugs with
+        //motor speeds. See ControlLayers.h.
+        enum Actuators {
+
+            kClimberLock, kClimberClimb, kClimberTranslate, kClimberWheel, kIntake, kLauncherIndex, kLauncherLaunch, kActuators
+        };
+        ControlLayers<ControllerState, kActuators> m_layersPlayerTwo;
 
         //This variable is used for each step of autonomous. See Hal
         //for more detail.
@@ -6,104 +6,333 @@
 #include <math.h>
 
 /*_____RoboRIO PWM Pin Declarations_____*/
-const int R_PWMPortClimberMotorClimb     = 0;
-const int R_PWMPortClimberServoLock      = 1;
-const int R_PWMPortClimberMotorWheel     = 2;
-const int R_PWMPortClimberMotorTranslate = 3;
+constexpr int R_PWMPortClimberMotorClimb     = 0;
+constexpr int R_PWMPortClimberServoLock      = 1;
+constexpr int R_PWMPortClimberMotorWheel     = 2;
+constexpr int R_PWMPortClimberMotorTranslate = 3;
 /*___End RoboRIO PWM Pin Declarations___*/
 
 /*_____RoboRIO DIO Pin Declarations_____*/
-const int R_DIOPortSwitchClimberBottom = 0;
-const int R_DIOPortSwitchSwerveUnlock  = 1;
+constexpr int R_DIOPortSwitchClimberBottom = 0;
+constexpr int R_DIOPortSwitchSwerveUnlock  = 1;
 /*___End RoboRIO DIO Pin Declarations___*/
 
+/*_____RoboRIO Analog Pin Declarations_____*/
+//The absolute encoders on the swerve modules, if they are wired in. A port
+//of -1 means that module has none, and is zeroed by hand.
+constexpr int R_analogPortZionFrontRightEncoder = -1;
+constexpr int R_analogPortZionFrontLeftEncoder  = -1;
+constexpr int R_analogPortZionRearLeftEncoder   = -1;
+constexpr int R_analogPortZionRearRightEncoder  = -1;
+/*___End RoboRIO Analog Pin Declarations___*/
+
 /*_____RoboRIO CAN Bus ID Declarations_____*/
-const int R_CANIDZionFrontRightSwerve = 1;
-const int R_CANIDZionFrontRightDrive  = 2;
-const int R_CANIDZionFrontLeftSwerve  = 3;
-const int R_CANIDZionFrontLeftDrive   = 4;
-const int R_CANIDZionRearLeftDrive    = 5;
-const int R_CANIDZionRearLeftSwerve   = 6;
-const int R_CANIDZionRearRightDrive   = 7;
-const int R_CANIDZionRearRightSwerve  = 8;
-
-const int R_CANIDMotorIntake = 9;
-
-const int R_CANIDMotorLauncherIndex  = 10;
-const int R_CANIDMotorLauncherLaunchOne = 11;
-const int R_CANIDMotorLauncherLaunchTwo = 12;
+constexpr int R_CANIDZionFrontRightSwerve = 1;
+constexpr int R_CANIDZionFrontRightDrive  = 2;
+constexpr int R_CANIDZionFrontLeftSwerve  = 3;
+constexpr int R_CANIDZionFrontLeftDrive   = 4;
+constexpr int R_CANIDZionRearLeftDrive    = 5;
+constexpr int R_CANIDZionRearLeftSwerve   = 6;
+constexpr int R_CANIDZionRearRightDrive   = 7;
+constexpr int R_CANIDZionRearRightSwerve  = 8;
+
+constexpr int R_CANIDMotorIntake = 9;
+
+constexpr int R_CANIDMotorLauncherIndex  = 10;
+constexpr int R_CANIDMotorLauncherLaunchOne = 11;
+constexpr int R_CANIDMotorLauncherLaunchTwo = 12;
 /*___End RoboRIO CAN Bus ID Declarations___*/
 
 /*_____Controller Settings_____*/
-const int R_controllerPortPlayerOne = 0;
-const int R_controllerPortPlayerTwo = 1;
+constexpr int R_controllerPortPlayerOne = 0;
+constexpr int R_controllerPortPlayerTwo = 1;
+//The most axes the Driver Station sends for one controller, all of which are
+//read into its ControllerState (see Controllers.h).
+constexpr int R_controllerMaxAxes = 12;
 
-//This deadzone is used to determine when the controller is completely motionless
-const double R_deadzoneController = .1;
+//This deadzone is used to determine when the controller is completely motionless.
+//It is round, so the stick counts the same in every direction (see
+//DriveInput.h).
+constexpr double R_deadzoneController = .1;
 //And this one is to determine when rotation is being induced, as simply operation
 //of the controller often results in errant rotation. Due to how easy it is to
-//drift, it is significantly higher.
-const double R_deadzoneControllerZ = .3;
+//drift, it is significantly higher...
+constexpr double R_deadzoneControllerZ = .3;
+//And grows by this fraction of itself with the stick pushed all the way.
+constexpr double R_deadzoneControllerZStrafe = .3;
+//How far the stick's magnitude and twist are bent toward their cubes (zero
+//is linear, one is cubic), for finer control at low speed.
+constexpr double R_inputExpoTranslation = .4;
+constexpr double R_inputExpoRotation = .4;
+//The most each of the stick's fractions of full speed may change per second.
+constexpr double R_inputSlewRate = 6;
 // This deadzone is for the maximum allowable Limelight offset.
-const double R_deadzoneLimelightX = 0.75;
+constexpr double R_deadzoneLimelightX = 0.75;
 
 //And this is the execution cap for how fast manual zeroing can occur.
-const double R_executionCapControllerZero = .1;
-
-//These are the playerTwo raw controller buttons that are used for manually
-//zeroing Zion one wheel at a time by holding them down.
-const int R_zeroButtonFR = 0;
-const int R_zeroButtonFL = 0;
-const int R_zeroButtonRL = 0;
-const int R_zeroButtonRR = 0;
+constexpr double R_executionCapControllerZero = .1;
+
+//These are the playerOne raw controller buttons (the ones on the base of the
+//joystick) that are used in test mode for manually zeroing Zion one wheel at
+//a time by holding them down, and for saving the zeros once straight.
+constexpr int R_zeroButtonFR = 7;
+constexpr int R_zeroButtonFL = 8;
+constexpr int R_zeroButtonRL = 9;
+constexpr int R_zeroButtonRR = 10;
+constexpr int R_zeroButtonSave = 11;
+
+//These are the playerOne raw controller buttons that, while held, pivot Zion
+//on the corner of its front left or front right bumper instead of its center.
+constexpr int R_pivotButtonFrontLeft = 5;
+constexpr int R_pivotButtonFrontRight = 6;
 /*___End Controller Settings___*/
 
 /*_____Global Robot Variable Settigns_____*/
-//This is the highest decimal percentage of full speed that Zion can actually go.
-const double R_executionCapZion = .80;
-//This is at what rate the regular execution cap is scaled for precision driving.
-const double R_executionCapZionPrecision = .25 * R_executionCapZion;
+//How often, in seconds, the robot's periodic functions are called.
+constexpr double R_robotLoopPeriod = .02;
+//This is the highest decimal percentage of full speed that Zion can actually
+//go. Module speeds are desaturated (see SwerveTrain.h), so this no longer has
+//to hide translation and rotation fighting over the fastest wheel.
+constexpr double R_executionCapZion = 1.;
+//Turning is still limited, as it can be violent. Before desaturation, the
+//twist was capped at .8 and then the wheels at .8 again, so this keeps the
+//.64 Zion was driven at.
+constexpr double R_executionCapZionRotation = .64;
+//This is the highest decimal percentage of full speed for precision driving.
+constexpr double R_executionCapZionPrecision = .2;
+//If true, Zion's swerves return to their nearest zero position whenever the
+//controller is let go. Otherwise they stay pointing where they last were, so
+//the next push in the same direction drives without turning back first.
+constexpr bool R_zionIdleAssumeZeroPosition = false;
 //This one is for running the intake motors.
-const double R_executionCapIntake = .75;
+constexpr double R_executionCapIntake = .75;
 
 //This is the default launcher index speed.
-const double R_launcherDefaultSpeedIndex = 1;
+constexpr double R_launcherDefaultSpeedIndex = 1;
 //And this the default launcher launch speed, for both distances and idle.
-const double R_launcherDefaultSpeedLaunch = .2;
-const double R_launcherDefaultSpeedLaunchClose = .7425;
-const double R_launcherDefaultSpeedLaunchFar = .76378;
+constexpr double R_launcherDefaultSpeedLaunch = .2;
+constexpr double R_launcherDefaultSpeedLaunchClose = .7425;
+constexpr double R_launcherDefaultSpeedLaunchFar = .76378;
 
 //This is the speed for automatic lateral movement in autonomous.
-const double R_zionAutoMovementSpeedLateral = .35;
+constexpr double R_zionAutoMovementSpeedLateral = .35;
 //And for rotational movement.
-const double R_zionAutoMovementSpeedRotational = .2;
+constexpr double R_zionAutoMovementSpeedRotational = .2;
 //This is the tolerance for autonomous angle assumption in degrees.
-const double R_zionAutoToleranceAngle = 10;
+constexpr double R_zionAutoToleranceAngle = 10;
 //This is how close to zero the Limelight's horizontal target offset can be
 //in order to be considered centered.
-const double R_zionAutoToleranceHorizontalOffset = .5;
+constexpr double R_zionAutoToleranceHorizontalOffset = .5;
 
 //The amount of REV rotations it takes for a swerve assembly to make a full rotation.
 //Often, a REV Rotation is referred to as a Nic, although they mean different things.
 //Truly, a Nic is ~17.976 REV Rotation values.
-const double R_nicsConstant = 17.9761447906494;
+constexpr double R_nicsConstant = 17.9761447906494;
+//If true, the angle math uses a polynomial approximation of the arctangent
+//instead of the standard library. It is faster on the roboRIO and is never
+//off by more than the error below, in radians. See Angle.h.
+constexpr bool R_angleUseFastAtan2 = false;
+constexpr double R_angleFastAtan2MaxError = .000012;
 //The change in encoder output per full wheel rotation around the axle.
 //This value can be used to move a certain distance using solely encoder values.
-const double R_kuhnsConstant = 8.3121115031;
+constexpr double R_kuhnsConstant = 8.3121115031;
 //If an xy coordinate plane is centered at the middle of the drivetrain, this
 //is the radian measure between the y-axis and the front right wheel. This is
 //the basic unit of a non-moving center turn, and it is modified as the basis
 //for moving and turning at the same time.
-const double R_angleFromCenterToFrontLeftWheel = 45.;
-const double R_angleFromCenterToFrontRightWheel = 315.;
-const double R_angleFromCenterToRearLeftWheel = 135.;
-const double R_angleFromCenterToRearRightWheel = 225.;
+constexpr double R_angleFromCenterToFrontLeftWheel = 45.;
+constexpr double R_angleFromCenterToFrontRightWheel = 315.;
+constexpr double R_angleFromCenterToRearLeftWheel = 135.;
+constexpr double R_angleFromCenterToRearRightWheel = 225.;
 
 //These contants are used for the functions which provide assuming a position.
 //See those functions for further detail.
-const double R_swerveTrainAssumePositionTolerance = .1;
-const double R_swerveTrainAssumePositionSpeedCalculationFirstEndBehaviorAt = 3.5;
-const double R_swerveTrainAssumePositionSpeedCalculationFirstEndBehaviorSpeed = .2;
-const double R_swerveTrainAssumePositionSpeedCalculationSecondEndBehaviorAt = 1;
-const double R_swerveTrainAssumePositionSpeedCalculationSecondEndBehaviorSpeed = .02;
+constexpr double R_swerveTrainAssumePositionTolerance = .1;
+constexpr double R_swerveTrainAssumePositionSpeedCalculationFirstEndBehaviorAt = 3.5;
+constexpr double R_swerveTrainAssumePositionSpeedCalculationFirstEndBehaviorSpeed = .2;
+constexpr double R_swerveTrainAssumePositionSpeedCalculationSecondEndBehaviorAt = 1;
+constexpr double R_swerveTrainAssumePositionSpeedCalculationSecondEndBehaviorSpeed = .02;
+//Between the end behaviors and half a rotation, the speed curve is read from
+//a table of this many points (see ResponseCurve.h). The build fails if the
+//table is ever off from the curve by more than the maximum error.
+constexpr int R_swerveTrainAssumePositionSpeedCalculationTableSize = 256;
+constexpr double R_swerveTrainAssumePositionSpeedCalculationTableMaxError = .0001;
+//How many loops the steering thread carries out the swerve targets it was
+//last handed before deciding the drivetrain's thread has stopped and
+//stopping the swerves itself. New targets come every loop, so more than one
+//keeps a late loop from stopping them for a moment.
+constexpr int R_swerveTrainSteeringTimeout = 2;
+
+//On Zion's MK2 modules, turning the swerve also turns the drive wheel through
+//the bevel gears, so the drive encoder counts steering as distance. This is
+//how many REV rotations of the drive encoder one full turn of a module adds:
+//the 15:45 bevel turns the wheel a third of a rotation, times the drive
+//reduction. Holding a wheel, turning its module one rotation clockwise, and
+//reading the drive encoder gives the sign.
+constexpr double R_zionDriveSteeringCoupling = R_kuhnsConstant / 3.;
+//If true, the coupling is taken out of the drive encoders' distance and
+//velocity, and under velocity control the drive motors also turn to cancel
+//out what steering does to the wheels. With the wrong sign each of these
+//doubles the error instead (in Hal's distances, in telling whether Zion is
+//still, and in the scrub), so it stays off until the sign above has been
+//measured on Zion.
+constexpr bool R_zionDriveSteeringCouplingMeasured = false;
+//The voltage an absolute swerve encoder reads at one full rotation. They
+//count clockwise, like the swerve motors, from 0 volts.
+constexpr double R_zionAbsoluteEncoderVoltage = 5.;
+
+//The diameter of a drive wheel, in inches.
+constexpr double R_zionWheelDiameter = 4.;
+//The distance, in inches, from the center of Zion to the axle of each swerve
+//module along both the x and y axis (the drivetrain is square).
+constexpr double R_zionModuleOffset = 11.25;
+//And the distance, in meters, straight from the center to each module.
+constexpr double R_zionModuleRadius = R_zionModuleOffset * M_SQRT2 * .0254;
+//The half-width of Zion's footprint with bumpers, in inches.
+constexpr double R_zionBumperHalfWidth = 17.5;
+//The free speed of a NEO, in RPM, as used by both drive and swerve motors.
+constexpr double R_NEOFreeSpeed = 5676;
+
+//The drive motors are voltage compensated to this many volts, so a given
+//output means the same speed whatever the battery is at, as long as it can
+//supply it. Set below what a tired battery sags to under load.
+constexpr double R_zionDriveNominalVoltage = 11.;
+//If true, drive speeds are commanded as wheel velocities through the Spark
+//MAX velocity PID, with a full speed of 1 being R_zionDriveMaxVelocity.
+//Otherwise they are voltage compensated duty cycle.
+constexpr bool R_zionDriveVelocityControl = true;
+//Meters per second of wheel travel per drive motor RPM...
+constexpr double R_zionDriveMetersPerSecondPerRPM = R_zionWheelDiameter * .0254 * M_PI / R_kuhnsConstant / 60.;
+//And the fastest the wheels can go at the nominal voltage, in meters per second.
+constexpr double R_zionDriveMaxVelocity = R_NEOFreeSpeed * (R_zionDriveNominalVoltage / 12.) * R_zionDriveMetersPerSecondPerRPM;
+//The fastest any one module is ever asked to drive, in meters per second.
+//If the controller asks for more, every module is slowed together.
+constexpr double R_zionMaxModuleSpeed = R_zionDriveMaxVelocity;
+//The drive velocity PID gains, in output per RPM of error. The feedforward
+//is the output that holds free speed at the nominal voltage, so the PID
+//only makes up for load and friction.
+constexpr double R_zionDriveVelocityP = .0001;
+constexpr double R_zionDriveVelocityI = 0;
+constexpr double R_zionDriveVelocityD = 0;
+constexpr double R_zionDriveVelocityFF = 1. / (R_NEOFreeSpeed * (R_zionDriveNominalVoltage / 12.));
+
+//The most the setpoint generator lets the drive command change each loop.
+//Drive acceleration is in meters per second squared (well inside what the
+//wheels can take before slipping), and steering rate is in Nics per second
+//(two module rotations, comfortably what assumeSwervePosition() keeps up
+//with). Modules slower than the stopped speed, in meters per second, may
+//point anywhere, since they are not driving yet.
+constexpr double R_zionSetpointMaxDriveAcceleration = 8.;
+constexpr double R_zionSetpointMaxSteeringRate = 2. * R_nicsConstant;
+constexpr double R_zionSetpointStoppedSpeed = .1;
+//How many halvings it takes to find how far toward a new command is reachable.
+constexpr int R_zionSetpointIterations = 10;
+
+//If true, each module watches for its swerve encoder drifting from where the
+//wheel really points, and moves its zero when it has. Where it really points
+//comes from the absolute encoder if it has one, and otherwise from how the
+//wheels and NavX say the robot is moving (see updateSteeringDrift()).
+constexpr bool R_zionSteeringDriftCorrection = true;
+//Without an absolute encoder, a wheel that has drifted mostly scrubs along
+//with the others, so how the robot moves only shows part of its drift, and
+//can blame a neighbor for it. Until that is proven on carpet, it is only
+//published, unless this is true.
+constexpr bool R_zionSteeringDriftCorrectionFromMotion = false;
+//Each sample of drift, in Nics, moves the estimate this fraction of the way
+//toward it, so a sample is averaged over roughly the inverse of it in loops.
+constexpr double R_zionSteeringDriftFilter = .02;
+//The estimate has to be off by this many Nics (about two degrees, as close as
+//assumeSwervePosition() points anyway) before the zero is moved, so noise
+//never walks it.
+constexpr double R_zionSteeringDriftThreshold = .1;
+//Samples are only taken while the swerves are turning slower than this, in
+//RPM, as both the absolute encoders and the wheels lag while steering...
+constexpr double R_zionSteeringDriftMaxSwerveSpeed = 200.;
+//And, from the NavX, while the robot moves faster than this, in meters per
+//second, since a wheel's direction means nothing when it is barely rolling.
+constexpr double R_zionSteeringDriftMinSpeed = .5;
+
+//Zion is still when every wheel is slower than this, in meters per second,
+//and the NavX feels less than this acceleration, in g's, along both axes.
+constexpr double R_zionStationaryMaxVelocity = .02;
+constexpr double R_navXStationaryMaxAcceleration = .02;
+//Once it has been still for this many loops (long enough for anything that
+//was still settling to stop), any turn the NavX reports is its own drift.
+constexpr int R_navXStationaryLoops = 25;
+//Each still loop's drift, in degrees per second, moves the estimate of the
+//NavX's bias this fraction of the way toward it. The bias is taken out of
+//the heading whenever Zion is moving, until it is still again.
+constexpr double R_navXBiasFilter = .01;
 /*___End Global Robot Variable Settings___*/
+
+/*_____Scheduler Settings_____*/
+//How often, in seconds, the swerves are steered toward their latest targets,
+//Zion carries out its drive commands, and the SmartDashboard is updated, on
+//their own threads (see Scheduler.h). Everything else runs in the main loop,
+//every R_robotLoopPeriod. The setpoint generator counts on drive commands
+//being carried out every R_robotLoopPeriod, so keep the two the same.
+constexpr double R_schedulerSteeringPeriod = .005;
+constexpr double R_schedulerDrivePeriod = R_robotLoopPeriod;
+constexpr double R_schedulerTelemetryPeriod = .1;
+//How often, in milliseconds, the swerve motors send their encoders' positions
+//(status frame 2, every 20 by default). Steering reads them every
+//R_schedulerSteeringPeriod, so they are sent as often, or it would act on the
+//same position four times over. A steering update takes under a tenth of a
+//millisecond, so the period has plenty of room; check Scheduler::Steering
+//on the SmartDashboard for missed deadlines on the robot.
+constexpr int R_schedulerSteeringFramePeriod = (int)(R_schedulerSteeringPeriod * 1000 + .5);
+//A task or loop that starts this fraction of a period late has missed its
+//deadline.
+constexpr double R_schedulerDeadlineTolerance = .5;
+//Real-time tasks run at this priority (1 to 99, under the HAL's own notifier
+//thread so that it is never starved) on this core, the second of the
+//roboRIO's two.
+constexpr int R_schedulerRealTimePriority = 35;
+constexpr int R_schedulerCPU = 1;
+/*___End Scheduler Settings___*/
+
+/*_____Drive Command Settings_____*/
+//How many drive commands can be waiting for Zion at once (see
+//CommandQueue.h). Must be a power of two.
+constexpr int R_driveCommandQueueSize = 16;
+//A drive command stands until this many seconds after it was made, unless
+//something newer at the same or a higher priority replaces it. Sources send
+//one every loop, so one that goes quiet for longer than this is taken as
+//gone, and Zion stops.
+constexpr double R_driveCommandTimeout = .1;
+//Which source wins when more than one is driving: higher beats lower.
+constexpr int R_driveCommandPriorityTeleop = 0;
+constexpr int R_driveCommandPriorityHal = 1;
+/*___End Drive Command Settings___*/
+
+/*_____Simulation Settings_____*/
+//These describe Zion as a rigid body for Simulation. Mass is in kilograms
+//(with battery and bumpers) and moment of inertia in kilogram meters squared.
+constexpr double R_simulationZionMass = 56.7;
+constexpr double R_simulationZionMomentOfInertia = 5.5;
+//The coefficient of friction between a wheel and the carpet. Each wheel can
+//exert at most this much force relative to the weight it carries.
+constexpr double R_simulationWheelFrictionCoefficient = 1.1;
+//The force, in newtons, a single stalled drive motor pushes with at the wheel.
+constexpr double R_simulationDriveStallForce = 425;
+//The fraction of a collision's speed kept when bouncing off of a wall.
+constexpr double R_simulationRestitution = .1;
+//The longest step, in seconds, the simulation takes at once. Longer steps are
+//broken up into steps of this size to keep the wheel forces stable.
+constexpr double R_simulationMaximumStep = .001;
+
+//Field geometry in inches, with the origin in the corner to the right of the
+//blue power port. X runs down the length of the field, Y across it.
+constexpr double R_fieldLength = 629.25;
+constexpr double R_fieldWidth = 323.25;
+//The trench runs along the side walls; its legs are the only part of it on
+//the carpet. These are approximated as boxes at the ends of each trench.
+constexpr double R_fieldTrenchLength = 216.;
+constexpr double R_fieldTrenchWidth = 55.5;
+constexpr double R_fieldTrenchLegSize = 4.;
+//The power ports sit in the alliance walls; the lower port's recess and its
+//frame stick out into the field by this much.
+constexpr double R_fieldPowerPortDepth = 4.;
+constexpr double R_fieldPowerPortWidth = 34.64;
+constexpr double R_fieldPowerPortCenterY = 94.66;
+/*___End Simulation Settings___*/
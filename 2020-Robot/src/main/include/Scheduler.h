@@ -0,0 +1,193 @@
+/*
+class Scheduler
+
+    Runs pieces of the robot at their own rates, each on its own thread, on
+        top of the TimedRobot loop (which stays the loop the modes and the
+        mechanisms run in). Each task is an frc::Notifier, so it is woken by
+        the FPGA's clock rather than slept for, and keeps to its period
+        whatever the others are doing. Tasks that ask for it run at
+        real-time priority on the roboRIO's second core, away from the main
+        loop and the network, so that steering is never held up by a
+        SmartDashboard flush.
+
+    Every task and loop counts its missed deadlines: it has missed one if it
+    started later than R_schedulerDeadlineTolerance periods after the last
+    time it did. A run that takes longer than its period always makes the
+    next one late, so that is counted too.
+
+Constructors
+
+    Scheduler()
+        Creates a scheduler with no tasks.
+
+Public Methods
+
+    void addTask(const std::string&, std::function<void()>, const double&, const bool& = false)
+        Adds a task, under the supplied name, that calls the supplied
+        function every supplied period, in seconds. If the bool is true,
+        the task runs at R_schedulerRealTimePriority on R_schedulerCPU.
+        Tasks only start once start() is called.
+    void addLoop(const std::string&, const double&)
+        Adds a loop, under the supplied name, that something else (like the
+        TimedRobot loop) runs every supplied period, to be counted with
+        account().
+    void start()
+        Starts every task.
+    void account(const std::string&)
+        Counts one run of the named loop, and whether it was late.
+    int getMisses(const std::string&)
+        Returns how many deadlines the named task or loop has missed.
+    void publish()
+        Puts the runs, missed deadlines, and longest run in seconds of every
+        task and loop to the SmartDashboard under Scheduler::. A loop's
+        longest run is the longest it went between runs.
+
+Private Methods
+
+    void run(Task*)
+        Runs a task once, counting it.
+    void count(Task*, const std::chrono::steady_clock::time_point&)
+        Counts one run of a task or loop that started at the supplied time,
+        and whether it was late.
+    void setRealTime()
+        Sets the calling thread to real-time priority on the second core.
+*/
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+
+#include <frc/Notifier.h>
+#include <frc/Threads.h>
+#include <frc/smartdashboard/SmartDashboard.h>
+
+#include "RobotMap.h"
+
+class Scheduler {
+
+    public:
+        Scheduler() {}
+
+        void addTask(const std::string &name, std::function<void()> function, const double &period, const bool &realTime = false) {
+
+            Task *task = new Task(name, period);
+            task->function = function;
+            task->realTime = realTime;
+            task->notifier = new frc::Notifier([this, task] {run(task);});
+            m_tasks[name] = task;
+        }
+        void addLoop(const std::string &name, const double &period) {
+
+            m_tasks[name] = new Task(name, period);
+        }
+        void start() {
+
+            for (const auto &task : m_tasks) {
+
+                if (task.second->notifier) {
+
+                    task.second->notifier->StartPeriodic(units::second_t(task.second->period));
+                }
+            }
+        }
+        void account(const std::string &name) {
+
+            //Loops are all added before anything runs, so the map is never
+            //changed while another thread reads it.
+            const auto task = m_tasks.find(name);
+            if (task != m_tasks.end()) {
+
+                count(task->second, std::chrono::steady_clock::now());
+            }
+        }
+        int getMisses(const std::string &name) {
+
+            const auto task = m_tasks.find(name);
+            return task == m_tasks.end() ? 0 : task->second->misses.load();
+        }
+        void publish() {
+
+            for (const auto &task : m_tasks) {
+
+                frc::SmartDashboard::PutNumber("Scheduler::" + task.first + "::Runs", task.second->runs.load());
+                frc::SmartDashboard::PutNumber("Scheduler::" + task.first + "::Misses", task.second->misses.load());
+                frc::SmartDashboard::PutNumber("Scheduler::" + task.first + "::MaxRuntime", task.second->maxRuntime.load());
+            }
+        }
+
+    private:
+        struct Task {
+
+            Task(const std::string &taskName, const double &taskPeriod) : name(taskName), period(taskPeriod) {}
+
+            std::string name;
+            std::function<void()> function;
+            double period;
+            bool realTime = false;
+            frc::Notifier *notifier = nullptr;
+
+            //Only ever touched by the thread that runs the task...
+            bool started = false;
+            std::chrono::steady_clock::time_point lastStart;
+            //And read by publish() from any other.
+            std::atomic<int> runs{0};
+            std::atomic<int> misses{0};
+            std::atomic<double> maxRuntime{0};
+        };
+
+        void run(Task *task) {
+
+            //A Notifier's thread is its own, so it can be moved to the
+            //second core the first time it runs.
+            if (!task->started && task->realTime) {
+
+                setRealTime();
+            }
+            const auto start = std::chrono::steady_clock::now();
+            count(task, start);
+            task->function();
+
+            const double runtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (runtime > task->maxRuntime.load()) {
+
+                task->maxRuntime = runtime;
+            }
+        }
+        void count(Task *task, const std::chrono::steady_clock::time_point &start) {
+
+            if (task->started) {
+
+                const double sinceLast = std::chrono::duration<double>(start - task->lastStart).count();
+                if (sinceLast > task->period * (1 + R_schedulerDeadlineTolerance)) {
+
+                    task->misses++;
+                }
+                //A loop has no run of its own to time, so how long it went
+                //between runs is the best measure of how long it took.
+                if (!task->notifier && sinceLast > task->maxRuntime.load()) {
+
+                    task->maxRuntime = sinceLast;
+                }
+            }
+            task->started = true;
+            task->lastStart = start;
+            task->runs++;
+        }
+        void setRealTime() {
+
+            frc::SetCurrentThreadPriority(true, R_schedulerRealTimePriority);
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(R_schedulerCPU, &cpus);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        }
+
+        std::map<std::string, Task*> m_tasks;
+};
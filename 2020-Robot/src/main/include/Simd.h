@@ -0,0 +1,189 @@
+/*
+struct Float4
+
+    Four floats operated on at once, one for each swerve module. On the
+        roboRIO (and any other ARM with NEON) this is a NEON register, on a
+        desktop with SSE it is an SSE register, and anywhere else it is a
+        plain array, so the same code builds everywhere and simply runs
+        faster where it can.
+
+Public Methods
+
+    static Float4 load(const float*)
+        Returns four floats read from the supplied array.
+    static Float4 broadcast(const float&)
+        Returns the supplied float in all four lanes.
+    void store(float*)
+        Writes the four lanes to the supplied array.
+    Float4 operator+, operator-, operator*, operator/ (const Float4&)
+    Float4 operator- ()
+        Lane by lane arithmetic.
+    static Float4 min(const Float4&, const Float4&)
+    static Float4 max(const Float4&, const Float4&)
+    static Float4 sqrt(const Float4&)
+        Lane by lane minimum, maximum, and square root.
+    float maxLane()
+        Returns the largest of the four lanes.
+*/
+
+#pragma once
+
+#include <math.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SIMD_NEON
+#elif defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define SIMD_SSE
+#endif
+
+struct Float4 {
+
+        static Float4 load(const float *values) {
+
+            Float4 result;
+            #if defined(SIMD_NEON)
+            result.lanes = vld1q_f32(values);
+            #elif defined(SIMD_SSE)
+            result.lanes = _mm_loadu_ps(values);
+            #else
+            for (int lane = 0; lane < 4; lane++) {result.lanes[lane] = values[lane];}
+            #endif
+            return result;
+        }
+        static Float4 broadcast(const float &value) {
+
+            Float4 result;
+            #if defined(SIMD_NEON)
+            result.lanes = vdupq_n_f32(value);
+            #elif defined(SIMD_SSE)
+            result.lanes = _mm_set1_ps(value);
+            #else
+            for (int lane = 0; lane < 4; lane++) {result.lanes[lane] = value;}
+            #endif
+            return result;
+        }
+        void store(float *values) const {
+
+            #if defined(SIMD_NEON)
+            vst1q_f32(values, lanes);
+            #elif defined(SIMD_SSE)
+            _mm_storeu_ps(values, lanes);
+            #else
+            for (int lane = 0; lane < 4; lane++) {values[lane] = lanes[lane];}
+            #endif
+        }
+
+        Float4 operator+ (const Float4 &other) const {
+
+            Float4 result;
+            #if defined(SIMD_NEON)
+            result.lanes = vaddq_f32(lanes, other.lanes);
+            #elif defined(SIMD_SSE)
+            result.lanes = _mm_add_ps(lanes, other.lanes);
+            #else
+            for (int lane = 0; lane < 4; lane++) {result.lanes[lane] = lanes[lane] + other.lanes[lane];}
+            #endif
+            return result;
+        }
+        Float4 operator- (const Float4 &other) const {
+
+            Float4 result;
+            #if defined(SIMD_NEON)
+            result.lanes = vsubq_f32(lanes, other.lanes);
+            #elif defined(SIMD_SSE)
+            result.lanes = _mm_sub_ps(lanes, other.lanes);
+            #else
+            for (int lane = 0; lane < 4; lane++) {result.lanes[lane] = lanes[lane] - other.lanes[lane];}
+            #endif
+            return result;
+        }
+        Float4 operator* (const Float4 &other) const {
+
+            Float4 result;
+            #if defined(SIMD_NEON)
+            result.lanes = vmulq_f32(lanes, other.lanes);
+            #elif defined(SIMD_SSE)
+            result.lanes = _mm_mul_ps(lanes, other.lanes);
+            #else
+            for (int lane = 0; lane < 4; lane++) {result.lanes[lane] = lanes[lane] * other.lanes[lane];}
+            #endif
+            return result;
+        }
+        Float4 operator/ (const Float4 &other) const {
+
+            Float4 result;
+            #if defined(SIMD_NEON)
+            //32-bit NEON has no divide, so refine its reciprocal estimate
+            //twice (each step doubles the correct bits) and multiply.
+            float32x4_t reciprocal = vrecpeq_f32(other.lanes);
+            reciprocal = vmulq_f32(vrecpsq_f32(other.lanes, reciprocal), reciprocal);
+            reciprocal = vmulq_f32(vrecpsq_f32(other.lanes, reciprocal), reciprocal);
+            result.lanes = vmulq_f32(lanes, reciprocal);
+            #elif defined(SIMD_SSE)
+            result.lanes = _mm_div_ps(lanes, other.lanes);
+            #else
+            for (int lane = 0; lane < 4; lane++) {result.lanes[lane] = lanes[lane] / other.lanes[lane];}
+            #endif
+            return result;
+        }
+        Float4 operator- () const {
+
+            return broadcast(0) - *this;
+        }
+
+        static Float4 min(const Float4 &first, const Float4 &second) {
+
+            Float4 result;
+            #if defined(SIMD_NEON)
+            result.lanes = vminq_f32(first.lanes, second.lanes);
+            #elif defined(SIMD_SSE)
+            result.lanes = _mm_min_ps(first.lanes, second.lanes);
+            #else
+            for (int lane = 0; lane < 4; lane++) {result.lanes[lane] = fminf(first.lanes[lane], second.lanes[lane]);}
+            #endif
+            return result;
+        }
+        static Float4 max(const Float4 &first, const Float4 &second) {
+
+            Float4 result;
+            #if defined(SIMD_NEON)
+            result.lanes = vmaxq_f32(first.lanes, second.lanes);
+            #elif defined(SIMD_SSE)
+            result.lanes = _mm_max_ps(first.lanes, second.lanes);
+            #else
+            for (int lane = 0; lane < 4; lane++) {result.lanes[lane] = fmaxf(first.lanes[lane], second.lanes[lane]);}
+            #endif
+            return result;
+        }
+        static Float4 sqrt(const Float4 &value) {
+
+            Float4 result;
+            #if defined(SIMD_SSE)
+            result.lanes = _mm_sqrt_ps(value.lanes);
+            #else
+            //32-bit NEON has no square root either, and the VFP unit's is
+            //exact, so take each lane through it.
+            float values[4];
+            value.store(values);
+            for (int lane = 0; lane < 4; lane++) {values[lane] = sqrtf(values[lane]);}
+            result = load(values);
+            #endif
+            return result;
+        }
+        float maxLane() const {
+
+            float values[4];
+            store(values);
+            return fmaxf(fmaxf(values[0], values[1]), fmaxf(values[2], values[3]));
+        }
+
+        #if defined(SIMD_NEON)
+        float32x4_t lanes;
+        #elif defined(SIMD_SSE)
+        __m128 lanes;
+        #else
+        float lanes[4];
+        #endif
+};
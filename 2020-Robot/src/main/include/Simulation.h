@@ -0,0 +1,444 @@
+/*
+class Simulation
+
+    Models Zion as a rigid body on the Infinite Recharge field so that
+        autonomous routines can be run and timed on a desktop. Each swerve
+        module is driven by the same duty cycle outputs the real motors
+        receive, pushes on the carpet through a traction-limited wheel, and
+        the sum of those pushes moves and rotates the chassis. Zion collides
+        with the field perimeter, the trench legs, and the power port frames.
+
+    Conventions
+        Field positions are in inches from the corner to the right of the blue
+        power port, with X down the length of the field and Y across it.
+        Headings are in degrees counterclockwise from the X axis. Zion's own
+        front is its Y axis, and swerve positions are in REV rotations
+        clockwise from straight, exactly as SwerveModule counts them.
+
+Constructors
+
+    Simulation(const double&, const double&, const double&)
+        Places Zion at the supplied X and Y (inches) and heading (degrees),
+        at rest, with every swerve pointed straight.
+
+Public Methods
+
+    void setModuleOutput(const int&, const double&, const double&)
+        Sets the drive and swerve duty cycle outputs of the supplied Module.
+        These persist until set again, just like a motor controller.
+    void step(const double&)
+        Advances the simulation by the supplied number of seconds. Long
+        steps are broken into steps of R_simulationMaximumStep.
+    void stepDevices(const double&)
+        Reads the outputs of Zion's FakeSparkMaxes off of their CAN IDs,
+        steps, and then writes the resulting encoder values back to them and
+        Zion's heading, turn rate, and accelerations to the FakeAHRS. Robot
+        classes built on FakeDevices can then be run against the simulation
+        as if it were the real robot.
+    void addObstacle(const double&, const double&, const double&, const double&)
+        Adds a box (minimum X, minimum Y, maximum X, maximum Y in inches)
+        that Zion collides with. The perimeter, trench legs, and power
+        ports are added on construction.
+    double getX()
+    double getY()
+    double getHeading()
+        Return Zion's field position in inches and heading in degrees.
+    double getYaw()
+    double getAngle()
+    double getWorldLinearAccelX()
+    double getWorldLinearAccelY()
+        Return what the NavX on Zion would report: yaw from -180 to 180
+        (zero at the starting heading), the continuous angle, and the linear
+        acceleration in g's along the field axes. The NavX is mounted upside
+        down, so it counts counterclockwise, which is what the field
+        oriented math in SwerveTrain and the turns in Hal expect.
+    double getDrivePosition(const int&)
+    double getSwervePosition(const int&)
+        Return the REV rotations the drive and swerve encoders of the
+        supplied Module would report. Like the real MK2s, turning the swerve
+        turns the drive encoder by R_zionDriveSteeringCoupling per rotation,
+        with the same unmeasured sign, so it cannot check that sign.
+    double getElapsedTime()
+        Returns the number of seconds simulated so far.
+    int getCollisionCount()
+        Returns how many steps Zion has spent touching something.
+
+    enum Module
+        Used to select a swerve module, in the same order SwerveTrain takes
+        them.
+
+Private Methods
+
+    void stepOnce(const double&)
+        Advances the simulation by one step no longer than the maximum.
+    void collide(const double&, const double&, const double&, const double&)
+        Pushes Zion out of a contact at the supplied field point (meters)
+        along the supplied normal, and removes the speed it had into it.
+*/
+
+#pragma once
+
+#include <math.h>
+
+#include <vector>
+
+#include "FakeDevices.h"
+#include "RobotMap.h"
+
+class Simulation {
+
+    public:
+        Simulation(const double &startX, const double &startY, const double &startHeading) {
+
+            m_x = startX * m_metersPerInch;
+            m_y = startY * m_metersPerInch;
+            m_heading = startHeading * (M_PI / 180);
+            m_startHeading = m_heading;
+            m_velocityX = 0;
+            m_velocityY = 0;
+            m_velocityAngular = 0;
+            m_accelerationX = 0;
+            m_accelerationY = 0;
+            m_elapsedTime = 0;
+            m_collisionCount = 0;
+
+            for (int module = 0; module < 4; module++) {
+
+                m_driveOutput[module] = 0;
+                m_swerveOutput[module] = 0;
+                m_drivePosition[module] = 0;
+                m_swervePosition[module] = 0;
+            }
+
+            //The modules sit on the corners of a square. Their names are as
+            //seen with Zion upside down (as it is for zeroing), which is how
+            //the R_angleFromCenterTo* angles count them, so from above the
+            //"right" modules are on the left and the other way around.
+            const double offset = R_zionModuleOffset * m_metersPerInch;
+            m_moduleX[kFrontRight] = -offset; m_moduleY[kFrontRight] = offset;
+            m_moduleX[kFrontLeft] = offset;   m_moduleY[kFrontLeft] = offset;
+            m_moduleX[kRearLeft] = offset;    m_moduleY[kRearLeft] = -offset;
+            m_moduleX[kRearRight] = -offset;  m_moduleY[kRearRight] = -offset;
+
+            //The legs at each end of both trenches, on their inside edge...
+            const double trenchStart = (R_fieldLength - R_fieldTrenchLength) / 2;
+            const double trenchEnd = trenchStart + R_fieldTrenchLength;
+            const double leg = R_fieldTrenchLegSize;
+            addObstacle(trenchStart - leg, R_fieldTrenchWidth - leg, trenchStart, R_fieldTrenchWidth);
+            addObstacle(trenchEnd, R_fieldTrenchWidth - leg, trenchEnd + leg, R_fieldTrenchWidth);
+            addObstacle(trenchStart - leg, R_fieldWidth - R_fieldTrenchWidth, trenchStart, R_fieldWidth - R_fieldTrenchWidth + leg);
+            addObstacle(trenchEnd, R_fieldWidth - R_fieldTrenchWidth, trenchEnd + leg, R_fieldWidth - R_fieldTrenchWidth + leg);
+            //And the power port frames, which are rotationally symmetric.
+            const double portHalfWidth = R_fieldPowerPortWidth / 2;
+            addObstacle(0, R_fieldPowerPortCenterY - portHalfWidth, R_fieldPowerPortDepth, R_fieldPowerPortCenterY + portHalfWidth);
+            addObstacle(R_fieldLength - R_fieldPowerPortDepth, R_fieldWidth - R_fieldPowerPortCenterY - portHalfWidth, R_fieldLength, R_fieldWidth - R_fieldPowerPortCenterY + portHalfWidth);
+        }
+
+        void setModuleOutput(const int &module, const double &driveOutput, const double &swerveOutput) {
+
+            m_driveOutput[module] = fmax(-1, fmin(1, driveOutput));
+            m_swerveOutput[module] = fmax(-1, fmin(1, swerveOutput));
+        }
+        void step(const double &seconds) {
+
+            double remaining = seconds;
+            while (remaining > 0) {
+
+                const double stepLength = fmin(remaining, R_simulationMaximumStep);
+                stepOnce(stepLength);
+                remaining -= stepLength;
+            }
+        }
+        void stepDevices(const double &seconds) {
+
+            const int driveIDs[4] = {R_CANIDZionFrontRightDrive, R_CANIDZionFrontLeftDrive, R_CANIDZionRearLeftDrive, R_CANIDZionRearRightDrive};
+            const int swerveIDs[4] = {R_CANIDZionFrontRightSwerve, R_CANIDZionFrontLeftSwerve, R_CANIDZionRearLeftSwerve, R_CANIDZionRearRightSwerve};
+
+            double lastDrivePosition[4];
+            double lastSwervePosition[4];
+            for (int module = 0; module < 4; module++) {
+
+                FakeSparkMax *driveMotor = FakeSparkMax::get(driveIDs[module]);
+                FakeSparkMax *swerveMotor = FakeSparkMax::get(swerveIDs[module]);
+                setModuleOutput(module, driveMotor ? driveMotor->Get() : 0, swerveMotor ? swerveMotor->Get() : 0);
+                lastDrivePosition[module] = m_drivePosition[module];
+                lastSwervePosition[module] = m_swervePosition[module];
+            }
+
+            step(seconds);
+
+            for (int module = 0; module < 4; module++) {
+
+                FakeSparkMax *driveMotor = FakeSparkMax::get(driveIDs[module]);
+                FakeSparkMax *swerveMotor = FakeSparkMax::get(swerveIDs[module]);
+                //Encoder velocities are in RPM.
+                if (driveMotor) {
+
+                    driveMotor->setEncoder(m_drivePosition[module], (m_drivePosition[module] - lastDrivePosition[module]) / seconds * 60);
+                }
+                if (swerveMotor) {
+
+                    swerveMotor->setEncoder(m_swervePosition[module], (m_swervePosition[module] - lastSwervePosition[module]) / seconds * 60);
+                }
+            }
+            FakeAHRS *gyro = FakeAHRS::get();
+            if (gyro) {
+
+                gyro->setAngle(getAngle());
+                gyro->setRate(m_velocityAngular * (180 / M_PI));
+                gyro->setWorldLinearAccel(getWorldLinearAccelX(), getWorldLinearAccelY());
+            }
+        }
+        void addObstacle(const double &minX, const double &minY, const double &maxX, const double &maxY) {
+
+            m_obstacles.push_back({minX * m_metersPerInch, minY * m_metersPerInch, maxX * m_metersPerInch, maxY * m_metersPerInch});
+        }
+
+        double getX() {
+
+            return m_x / m_metersPerInch;
+        }
+        double getY() {
+
+            return m_y / m_metersPerInch;
+        }
+        double getHeading() {
+
+            return m_heading * (180 / M_PI);
+        }
+        double getYaw() {
+
+            return remainder((m_heading - m_startHeading) * (180 / M_PI), 360);
+        }
+        double getAngle() {
+
+            return (m_heading - m_startHeading) * (180 / M_PI);
+        }
+        double getWorldLinearAccelX() {
+
+            return m_accelerationX / m_gravity;
+        }
+        double getWorldLinearAccelY() {
+
+            return m_accelerationY / m_gravity;
+        }
+        double getDrivePosition(const int &module) {
+
+            return m_drivePosition[module];
+        }
+        double getSwervePosition(const int &module) {
+
+            return m_swervePosition[module];
+        }
+        double getElapsedTime() {
+
+            return m_elapsedTime;
+        }
+        int getCollisionCount() {
+
+            return m_collisionCount;
+        }
+
+        enum Module {
+
+            kFrontRight, kFrontLeft, kRearLeft, kRearRight
+        };
+
+    private:
+        void stepOnce(const double &seconds) {
+
+            const double cosHeading = cos(m_heading);
+            const double sinHeading = sin(m_heading);
+            //Zion's velocity in its own frame (Y forward, X to the right)...
+            const double robotVelocityX = m_velocityX * sinHeading - m_velocityY * cosHeading;
+            const double robotVelocityY = m_velocityX * cosHeading + m_velocityY * sinHeading;
+
+            const double freeSpeed = (R_NEOFreeSpeed / 60) / R_kuhnsConstant * R_zionWheelDiameter * M_PI * m_metersPerInch;
+            const double tractionLimit = R_simulationWheelFrictionCoefficient * R_simulationZionMass * m_gravity / 4;
+
+            double forceX = 0;
+            double forceY = 0;
+            double torque = 0;
+            for (int module = 0; module < 4; module++) {
+
+                //The swerve motor is assumed to reach its speed instantly,
+                //and turns the drive encoder through the gears as it goes...
+                const double swerveChange = m_swerveOutput[module] * (R_NEOFreeSpeed / 60) * seconds;
+                m_swervePosition[module] += swerveChange;
+                m_drivePosition[module] += R_zionDriveSteeringCoupling * swerveChange / R_nicsConstant;
+                const double swerveAngle = 2 * M_PI * m_swervePosition[module] / R_nicsConstant;
+                const double wheelX = sin(swerveAngle);
+                const double wheelY = cos(swerveAngle);
+
+                //How fast the carpet under the wheel is moving, along the
+                //wheel and across it (the robot spins counterclockwise)...
+                const double moduleVelocityX = robotVelocityX - m_velocityAngular * m_moduleY[module];
+                const double moduleVelocityY = robotVelocityY + m_velocityAngular * m_moduleX[module];
+                const double alongSpeed = moduleVelocityX * wheelX + moduleVelocityY * wheelY;
+                const double acrossSpeed = moduleVelocityX * wheelY - moduleVelocityY * wheelX;
+
+                //The drive motor pushes less the faster it already goes, and
+                //the tread resists sliding sideways as hard as it can...
+                double alongForce = R_simulationDriveStallForce * (m_driveOutput[module] - alongSpeed / freeSpeed);
+                double acrossForce = -acrossSpeed * (R_simulationZionMass / 4) / seconds;
+                //But neither can push harder than the carpet allows.
+                const double totalForce = hypot(alongForce, acrossForce);
+                double wheelSpeed = alongSpeed;
+                if (totalForce > tractionLimit) {
+
+                    alongForce *= tractionLimit / totalForce;
+                    acrossForce *= tractionLimit / totalForce;
+                    //Once slipping, the wheel spins at whatever the motor
+                    //can drive it to instead of rolling with the carpet.
+                    wheelSpeed = m_driveOutput[module] * freeSpeed;
+                }
+                m_drivePosition[module] += wheelSpeed * seconds / (R_zionWheelDiameter * M_PI * m_metersPerInch) * R_kuhnsConstant;
+
+                const double moduleForceX = alongForce * wheelX + acrossForce * wheelY;
+                const double moduleForceY = alongForce * wheelY - acrossForce * wheelX;
+                forceX += moduleForceX;
+                forceY += moduleForceY;
+                //Counterclockwise torque is positive.
+                torque += m_moduleX[module] * moduleForceY - m_moduleY[module] * moduleForceX;
+            }
+
+            //Turn the force back into the field frame and integrate.
+            m_accelerationX = (forceX * sinHeading + forceY * cosHeading) / R_simulationZionMass;
+            m_accelerationY = (-forceX * cosHeading + forceY * sinHeading) / R_simulationZionMass;
+            m_velocityX += m_accelerationX * seconds;
+            m_velocityY += m_accelerationY * seconds;
+            m_velocityAngular += torque / R_simulationZionMomentOfInertia * seconds;
+            m_x += m_velocityX * seconds;
+            m_y += m_velocityY * seconds;
+            m_heading += m_velocityAngular * seconds;
+
+            //Check every bumper corner against the walls and obstacles, and
+            //every obstacle corner against the bumpers.
+            bool collided = false;
+            const double cosMoved = cos(m_heading);
+            const double sinMoved = sin(m_heading);
+            const double halfWidth = R_zionBumperHalfWidth * m_metersPerInch;
+            const double fieldLength = R_fieldLength * m_metersPerInch;
+            const double fieldWidth = R_fieldWidth * m_metersPerInch;
+            const double cornerSigns[4][2] = {{1, 1}, {-1, 1}, {-1, -1}, {1, -1}};
+            for (int corner = 0; corner < 4; corner++) {
+
+                const double cornerX = m_x + halfWidth * (cornerSigns[corner][0] * sinMoved + cornerSigns[corner][1] * cosMoved);
+                const double cornerY = m_y + halfWidth * (-cornerSigns[corner][0] * cosMoved + cornerSigns[corner][1] * sinMoved);
+
+                if (cornerX < 0) {collide(cornerX, cornerY, 1, 0); m_x -= cornerX; collided = true;}
+                if (cornerX > fieldLength) {collide(cornerX, cornerY, -1, 0); m_x -= cornerX - fieldLength; collided = true;}
+                if (cornerY < 0) {collide(cornerX, cornerY, 0, 1); m_y -= cornerY; collided = true;}
+                if (cornerY > fieldWidth) {collide(cornerX, cornerY, 0, -1); m_y -= cornerY - fieldWidth; collided = true;}
+
+                for (const Obstacle &obstacle : m_obstacles) {
+
+                    if (cornerX > obstacle.minX && cornerX < obstacle.maxX && cornerY > obstacle.minY && cornerY < obstacle.maxY) {
+
+                        //Leave through whichever face is closest.
+                        const double depths[4] = {cornerX - obstacle.minX, obstacle.maxX - cornerX, cornerY - obstacle.minY, obstacle.maxY - cornerY};
+                        const double normals[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+                        int face = 0;
+                        for (int candidate = 1; candidate < 4; candidate++) {
+
+                            if (depths[candidate] < depths[face]) {
+
+                                face = candidate;
+                            }
+                        }
+                        collide(cornerX, cornerY, normals[face][0], normals[face][1]);
+                        m_x += normals[face][0] * depths[face];
+                        m_y += normals[face][1] * depths[face];
+                        collided = true;
+                    }
+                }
+            }
+            for (const Obstacle &obstacle : m_obstacles) {
+
+                const double obstacleCorners[4][2] = {{obstacle.minX, obstacle.minY}, {obstacle.maxX, obstacle.minY}, {obstacle.maxX, obstacle.maxY}, {obstacle.minX, obstacle.maxY}};
+                for (int corner = 0; corner < 4; corner++) {
+
+                    //Put the obstacle corner into Zion's frame...
+                    const double offsetX = obstacleCorners[corner][0] - m_x;
+                    const double offsetY = obstacleCorners[corner][1] - m_y;
+                    const double robotX = offsetX * sinMoved - offsetY * cosMoved;
+                    const double robotY = offsetX * cosMoved + offsetY * sinMoved;
+                    if (fabs(robotX) < halfWidth && fabs(robotY) < halfWidth) {
+
+                        //And push Zion away along whichever bumper is closest.
+                        const bool alongX = halfWidth - fabs(robotX) < halfWidth - fabs(robotY);
+                        const double depth = alongX ? halfWidth - fabs(robotX) : halfWidth - fabs(robotY);
+                        const double normalRobotX = alongX ? (robotX > 0 ? -1 : 1) : 0;
+                        const double normalRobotY = alongX ? 0 : (robotY > 0 ? -1 : 1);
+                        const double normalX = normalRobotX * sinMoved + normalRobotY * cosMoved;
+                        const double normalY = -normalRobotX * cosMoved + normalRobotY * sinMoved;
+                        collide(obstacleCorners[corner][0], obstacleCorners[corner][1], normalX, normalY);
+                        m_x += normalX * depth;
+                        m_y += normalY * depth;
+                        collided = true;
+                    }
+                }
+            }
+
+            if (collided) {
+
+                m_collisionCount++;
+            }
+            m_elapsedTime += seconds;
+        }
+        void collide(const double &pointX, const double &pointY, const double &normalX, const double &normalY) {
+
+            //The contact point relative to the center, and how fast it is
+            //moving into the contact...
+            const double radiusX = pointX - m_x;
+            const double radiusY = pointY - m_y;
+            const double pointVelocityX = m_velocityX - m_velocityAngular * radiusY;
+            const double pointVelocityY = m_velocityY + m_velocityAngular * radiusX;
+            const double closingSpeed = pointVelocityX * normalX + pointVelocityY * normalY;
+
+            //If it is already separating, there is nothing to do.
+            if (closingSpeed >= 0) {
+
+                return;
+            }
+            //Otherwise, apply the impulse that stops (and slightly bounces)
+            //the contact point, split between moving and spinning Zion.
+            const double radiusCrossNormal = radiusX * normalY - radiusY * normalX;
+            const double impulse = -(1 + R_simulationRestitution) * closingSpeed / (1 / R_simulationZionMass + radiusCrossNormal * radiusCrossNormal / R_simulationZionMomentOfInertia);
+            m_velocityX += impulse * normalX / R_simulationZionMass;
+            m_velocityY += impulse * normalY / R_simulationZionMass;
+            m_velocityAngular += impulse * radiusCrossNormal / R_simulationZionMomentOfInertia;
+        }
+
+        struct Obstacle {
+
+            double minX;
+            double minY;
+            double maxX;
+            double maxY;
+        };
+
+        const double m_metersPerInch = .0254;
+        const double m_gravity = 9.80665;
+
+        double m_x;
+        double m_y;
+        double m_heading;
+        double m_startHeading;
+        double m_velocityX;
+        double m_velocityY;
+        double m_velocityAngular;
+        double m_accelerationX;
+        double m_accelerationY;
+        double m_elapsedTime;
+        int m_collisionCount;
+
+        double m_moduleX[4];
+        double m_moduleY[4];
+        double m_driveOutput[4];
+        double m_swerveOutput[4];
+        double m_drivePosition[4];
+        double m_swervePosition[4];
+
+        std::vector<Obstacle> m_obstacles;
+};
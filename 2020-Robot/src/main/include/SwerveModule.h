@@ -1,17 +1,30 @@
 /*
-class SwerveModule
+class BasicSwerveModule<Devices>
+
+    Usually used as SwerveModule, which is built on RevDevices. See Devices.h.
 
 Constructors
 
-    SwerveModule(const int&, const int&)
+    SwerveModule(const int&, const int&, const int& = -1)
         Creates a swerve module with Spark MAX motor controllers on the
         two supplied CAN IDs, the first controlling drive, the second
-        controlling swerve.
+        controlling swerve, and an absolute encoder on the swerve on the
+        supplied analog port, if it is not -1.
 
 Public Methods
 
     void setDriveSpeed(const double&)
-        Sets the driving speed to a double. Defaults to zero.
+        Sets the driving speed to a double. Defaults to zero. With
+        R_zionDriveVelocityControl, a speed of 1 is R_zionDriveMaxVelocity,
+        held by the Spark MAX's velocity PID; otherwise it is duty cycle.
+        Either way it is compensated to R_zionDriveNominalVoltage, and a
+        speed of exactly zero lets the wheel coast rather than braking it.
+    void setDriveVelocity(const double&)
+        Commands the drive wheel to the supplied linear velocity in meters
+        per second through the Spark MAX's velocity PID. With
+        R_zionDriveSteeringCouplingMeasured, the drive motor also keeps
+        up with whatever the swerve is turning the wheel by, so the wheel
+        itself holds the velocity while steering.
     void setSwerveSpeed(const double&)
         Sets the swerve speed to a double. Defaults to zero.
         void setSwerveBrake(const bool &)
@@ -26,9 +39,40 @@ Public Methods
         This is used in SwerveTrain to allow "unlocking" the swerve wheels
         for zeroing by overriding the default brake initialization.
     void setZeroPosition()
-        Sets the zero position to the current position.
+        Sets the zero position to the current position. This, and everything
+        else that changes the calibration below, is only called from the
+        thread that owns the drivetrain; see SwerveTrain.h.
+    void loadZeroPosition()
+        Sets the zero position from the absolute encoder and the offset
+        saved for it by saveZeroPosition(), so that it survives power
+        cycles. Without either, the same as setZeroPosition().
+    void saveZeroPosition()
+        Saves what the absolute encoder reads at the current zero position
+        to the roboRIO's Preferences, under Zion::Swerve::ZeroOffset and
+        the swerve CAN ID. Does nothing without an absolute encoder.
+    void updateSteeringDrift()
+        Called every loop. Keeps the zero position within a rotation of the
+        swerve, so that the position never grows without end, and, if the
+        module has an absolute encoder and a saved offset for it, samples
+        how far the swerve encoder has drifted from it into
+        addSteeringDriftSample().
+    void addSteeringDriftSample(const double&, const bool& = R_zionSteeringDriftCorrection)
+        Averages in one sample of how many Nics clockwise of where the wheel
+        really points the swerve encoder says it is. Once the average passes
+        R_zionSteeringDriftThreshold, and if the bool is true, moves the zero
+        position by it and starts again.
+    double getSteeringDrift()
+        Returns the average drift so far, in Nics.
+    bool getAbsoluteEncoderPresent()
+        Returns true if the module was given an absolute encoder.
+    double getAbsolutePosition()
+        Returns the absolute encoder's position, in rotations clockwise
+        from 0 to 1.
     double getDrivePosition()
-        Returns the total REV revolutions of the drive encoder.
+        Returns the total REV revolutions of the drive encoder. With
+        R_zionDriveSteeringCouplingMeasured, less those the swerve caused by
+        turning the wheel through the gears (see
+        R_zionDriveSteeringCoupling), so that it only counts driving.
     double getSwervePosition()
         Returns the total REV revolutions of the swerve encoder.
     double getSwervePositionSingleRotation()
@@ -46,16 +90,23 @@ Public Methods
         this works.
     double getDriveSpeed()
         Returns the speed of the drive encoder in RPM.
+    double getDriveVelocity()
+        Returns the linear velocity of the drive wheel in meters per second,
+        less the swerve's part as above.
     double getSwerveSpeed()
         Returns the speed of the swerve encoder in RPM.
     Note that the values returned by the get functions persist across disables, but
         not across power cycles.
-    double getStandardDegreeSwervePosition(VectorDouble&, const double&)
-        D O C U M E N T  M E
-    void assumeSwervePosition(const double& positionToAssume)
+    double getStandardDegreeSwervePosition(const Vec2d&, const double&)
+        Returns the position in Nics that points the module along the
+        supplied vector, which is in standard position relative to the
+        robot, given the supplied NavX angle in degrees.
+    void assumeSwervePosition(const double&, const double& = 0)
         Uses a mathematical function to assign a speed to the swerve motor to
         move quickly and accurately, within a tolerance, to any REV rotation
-        value, clockwise or counterclockwise, with an optimal path. See the
+        value, clockwise or counterclockwise, with an optimal path. If the
+        position is itself moving, its rate in REV rotations per second can
+        be supplied, and the speed to keep up with it is added on. See the
         function itself for further detail.
     void assumeSwerveZeroPosition()
         Drives the swerve to the current value of the swerve's zero position
@@ -79,39 +130,81 @@ Private Methods
         was developed, regressed, and tuned to move to the final position as
         fast as possible initially, slowing down as it approaches and becoming
         linear as it settles into tolerance at a high accuracy.
+        The exponential part is read from a table built at compile time
+        (see ResponseCurve.h) for distances up to half a rotation.
+    double getSteeringCouplingSpeed()
+        Returns how fast, in RPM, the drive encoder is turning only because
+        the swerve is, or zero without R_zionDriveSteeringCouplingMeasured.
+    double getAbsoluteClockwiseNicsFromZero()
+        Returns how far clockwise of straight the absolute encoder and its
+        offset say the wheel is, in Nics from 0 to one Nic's Constant.
 */
 
 #pragma once
 
 #include <math.h>
 
-#include "rev/CANSparkMax.h"
+#include <atomic>
+#include <string>
 
+#include "Angle.h"
+#include "Devices.h"
 #include "RobotMap.h"
-#include "VectorDouble.h"
+#include "Vec2.h"
 
-class SwerveModule {
+template <class Devices>
+class BasicSwerveModule {
 
     public:
-        SwerveModule(const int &canDriveID, const int &canSwerveID) {
-
-            m_driveMotor = new rev::CANSparkMax(canDriveID, rev::CANSparkMax::MotorType::kBrushless);
-            m_driveMotorEncoder = new rev::CANEncoder(m_driveMotor->GetEncoder());
-            m_swerveMotor = new rev::CANSparkMax(canSwerveID, rev::CANSparkMax::MotorType::kBrushless);
-            m_swerveMotorEncoder = new rev::CANEncoder(m_swerveMotor->GetEncoder());
+        BasicSwerveModule(const int &canDriveID, const int &canSwerveID, const int &analogAbsoluteEncoderPort = -1) {
+
+            m_driveMotor = new typename Devices::SparkMax(canDriveID, Devices::SparkMax::MotorType::kBrushless);
+            m_driveMotorEncoder = new typename Devices::SparkMaxEncoder(m_driveMotor->GetEncoder());
+            m_swerveMotor = new typename Devices::SparkMax(canSwerveID, Devices::SparkMax::MotorType::kBrushless);
+            m_swerveMotorEncoder = new typename Devices::SparkMaxEncoder(m_swerveMotor->GetEncoder());
+            m_driveMotorPIDController = new typename Devices::SparkMaxPIDController(m_driveMotor->GetPIDController());
+
+            //Voltage compensate the drive, and give its velocity PID the
+            //gains to follow setDriveVelocity().
+            m_driveMotor->EnableVoltageCompensation(R_zionDriveNominalVoltage);
+            m_driveMotorPIDController->SetP(R_zionDriveVelocityP);
+            m_driveMotorPIDController->SetI(R_zionDriveVelocityI);
+            m_driveMotorPIDController->SetD(R_zionDriveVelocityD);
+            m_driveMotorPIDController->SetFF(R_zionDriveVelocityFF);
+            m_driveMotorPIDController->SetOutputRange(-1, 1);
 
             //Default the swerve's zero position to its power-on position.
+            //One saved from an absolute encoder is loaded later, with
+            //loadZeroPosition(), as Preferences are not ready this early.
             m_swerveZeroPosition = m_swerveMotorEncoder->GetPosition();
+            m_absoluteEncoder = analogAbsoluteEncoderPort >= 0 ? new typename Devices::AnalogInput(analogAbsoluteEncoderPort) : nullptr;
+            m_zeroOffsetKey = "Zion::Swerve::ZeroOffset" + std::to_string(canSwerveID);
+            m_zeroOffset = 0;
+            m_zeroOffsetKnown = false;
+            m_steeringDrift = 0;
 
             //Allow the drive motor to coast, but brake the swerve motor for accuracy.
             //These must be set as they become overwritten from code.
-            m_driveMotor->SetIdleMode(rev::CANSparkMax::IdleMode::kCoast);
-            m_swerveMotor->SetIdleMode(rev::CANSparkMax::IdleMode::kBrake);
+            m_driveMotor->SetIdleMode(Devices::SparkMax::IdleMode::kCoast);
+            m_swerveMotor->SetIdleMode(Devices::SparkMax::IdleMode::kBrake);
+            //Send the swerve's position as often as it is steered.
+            m_swerveMotor->SetPeriodicFramePeriod(Devices::SparkMax::PeriodicFrame::kStatus2, R_schedulerSteeringFramePeriod);
         }
 
         void setDriveSpeed(const double &speedToSet = 0) {
 
-            m_driveMotor->Set(speedToSet);
+            if (R_zionDriveVelocityControl && speedToSet != 0) {
+
+                setDriveVelocity(speedToSet * R_zionDriveMaxVelocity);
+            }
+            else {
+
+                m_driveMotor->Set(speedToSet);
+            }
+        }
+        void setDriveVelocity(const double &velocityToSet) {
+
+            m_driveMotorPIDController->SetReference(velocityToSet / R_zionDriveMetersPerSecondPerRPM + getSteeringCouplingSpeed(), Devices::ControlType::kVelocity);
         }
         void setSwerveSpeed(const double &speedToSet = 0) {
 
@@ -121,32 +214,108 @@ class SwerveModule {
 
             if (brake) {
 
-                m_driveMotor->SetIdleMode(rev::CANSparkMax::IdleMode::kBrake);
+                m_driveMotor->SetIdleMode(Devices::SparkMax::IdleMode::kBrake);
             }
             else {
 
-                m_driveMotor->SetIdleMode(rev::CANSparkMax::IdleMode::kCoast);
+                m_driveMotor->SetIdleMode(Devices::SparkMax::IdleMode::kCoast);
             }
         }
         void setSwerveBrake(const bool &brake) {
 
             if (brake) {
 
-                m_swerveMotor->SetIdleMode(rev::CANSparkMax::IdleMode::kBrake);
+                m_swerveMotor->SetIdleMode(Devices::SparkMax::IdleMode::kBrake);
             }
             else {
 
-                m_swerveMotor->SetIdleMode(rev::CANSparkMax::IdleMode::kCoast);
+                m_swerveMotor->SetIdleMode(Devices::SparkMax::IdleMode::kCoast);
             }
         }
         void setZeroPosition() {
 
             m_swerveZeroPosition = m_swerveMotorEncoder->GetPosition();
+            m_steeringDrift = 0;
+        }
+        void loadZeroPosition() {
+
+            //Without an absolute encoder, or a saved offset for it, zero is
+            //wherever the wheel is now, as it always was...
+            if (!m_absoluteEncoder || !Devices::Preferences::GetInstance()->ContainsKey(m_zeroOffsetKey)) {
+
+                setZeroPosition();
+                return;
+            }
+            //Otherwise, the wheel is as far clockwise from straight as the
+            //absolute encoder is from its offset, whatever the relative
+            //encoder happened to start at.
+            m_zeroOffset = Devices::Preferences::GetInstance()->GetDouble(m_zeroOffsetKey, 0);
+            m_zeroOffsetKnown = true;
+            m_swerveZeroPosition = m_swerveMotorEncoder->GetPosition() - getAbsoluteClockwiseNicsFromZero();
+            m_steeringDrift = 0;
+        }
+        void saveZeroPosition() {
+
+            if (!m_absoluteEncoder) {
+
+                return;
+            }
+            //The offset is what the absolute encoder would read at zero,
+            //which is where it is now, less how far the wheel is from zero.
+            double offset = getAbsolutePosition() - (m_swerveMotorEncoder->GetPosition() - m_swerveZeroPosition) / R_nicsConstant;
+            offset -= floor(offset);
+            Devices::Preferences::GetInstance()->PutDouble(m_zeroOffsetKey, offset);
+            m_zeroOffset = offset;
+            m_zeroOffsetKnown = true;
+        }
+        void updateSteeringDrift() {
+
+            //Take whole rotations out from between the swerve and its zero,
+            //which points the wheel the same way, so that fmod() never has
+            //to work on a position that has grown all match...
+            m_swerveZeroPosition = m_swerveZeroPosition + R_nicsConstant * trunc((m_swerveMotorEncoder->GetPosition() - m_swerveZeroPosition) / R_nicsConstant);
+            //And if there is an absolute encoder to check against, and the
+            //swerve is still enough for its reading to have caught up, the
+            //drift is how far the two disagree.
+            if (m_absoluteEncoder && m_zeroOffsetKnown && fabs(getSwerveSpeed()) < R_zionSteeringDriftMaxSwerveSpeed) {
+
+                addSteeringDriftSample(getSwervePositionSingleRotation() - getAbsoluteClockwiseNicsFromZero());
+            }
+        }
+        void addSteeringDriftSample(const double &drift, const bool &correct = R_zionSteeringDriftCorrection) {
+
+            m_steeringDrift += R_zionSteeringDriftFilter * (remainder(drift, R_nicsConstant) - m_steeringDrift);
+            //If the encoder reads clockwise of the wheel, its zero is that
+            //much counterclockwise of straight, so move it back.
+            if (correct && fabs(m_steeringDrift) > R_zionSteeringDriftThreshold) {
+
+                m_swerveZeroPosition = m_swerveZeroPosition + m_steeringDrift;
+                m_steeringDrift = 0;
+            }
+        }
+        double getSteeringDrift() {
+
+            return m_steeringDrift;
+        }
+        bool getAbsoluteEncoderPresent() {
+
+            return m_absoluteEncoder != nullptr;
+        }
+        double getAbsolutePosition() {
+
+            return m_absoluteEncoder->GetVoltage() / R_zionAbsoluteEncoderVoltage;
         }
 
         double getDrivePosition() {
 
-            return m_driveMotorEncoder->GetPosition();
+            //The MK2's gears turn the drive encoder as the swerve turns, so
+            //take out a coupling's worth for every rotation of the module,
+            //once it is known which way that is.
+            if (!R_zionDriveSteeringCouplingMeasured) {
+
+                return m_driveMotorEncoder->GetPosition();
+            }
+            return m_driveMotorEncoder->GetPosition() - R_zionDriveSteeringCoupling * m_swerveMotorEncoder->GetPosition() / R_nicsConstant;
         }
         double getSwervePosition() {
 
@@ -190,17 +359,20 @@ class SwerveModule {
 
             return m_driveMotorEncoder->GetVelocity();
         }
+        double getDriveVelocity() {
+
+            return (m_driveMotorEncoder->GetVelocity() - getSteeringCouplingSpeed()) * R_zionDriveMetersPerSecondPerRPM;
+        }
         double getSwerveSpeed() {
 
             return m_swerveMotorEncoder->GetVelocity();
         }
-        //TODO: Inline function documentation
-        double getStandardDegreeSwervePosition(VectorDouble &vector, const double &angle) {
+        double getStandardDegreeSwervePosition(const Vec2d &vector, const double &angle) {
 
-            return (R_nicsConstant * (vector.unitCircleAngleDeg() + angle - 90.) / 360.);
+            return (R_nicsConstant * (Angle::standardDegrees(vector.i, vector.j) + angle - 90.) / 360.);
         }
 
-        void assumeSwervePosition(const double &positionToAssume);
+        void assumeSwervePosition(const double &positionToAssume, const double &positionRate = 0);
         void assumeSwerveZeroPosition() {
 
             assumeSwervePosition(m_swerveZeroPosition);
@@ -212,11 +384,35 @@ class SwerveModule {
 
     private:
         double calculateAssumePositionSpeed(const double &howFarRemainingInTravel);
+        double getSteeringCouplingSpeed() {
 
-        rev::CANSparkMax *m_driveMotor;
-        rev::CANEncoder *m_driveMotorEncoder;
-        rev::CANSparkMax *m_swerveMotor;
-        rev::CANEncoder *m_swerveMotorEncoder;
+            return R_zionDriveSteeringCouplingMeasured ? R_zionDriveSteeringCoupling * m_swerveMotorEncoder->GetVelocity() / R_nicsConstant : 0;
+        }
+        double getAbsoluteClockwiseNicsFromZero() {
+
+            double fromZero = getAbsolutePosition() - m_zeroOffset;
+            fromZero -= floor(fromZero);
+            return fromZero * R_nicsConstant;
+        }
 
-        double m_swerveZeroPosition;
+        friend class Benchmark;
+        friend class GoldenCheck;
+
+        typename Devices::SparkMax *m_driveMotor;
+        typename Devices::SparkMaxEncoder *m_driveMotorEncoder;
+        typename Devices::SparkMaxPIDController *m_driveMotorPIDController;
+        typename Devices::SparkMax *m_swerveMotor;
+        typename Devices::SparkMaxEncoder *m_swerveMotorEncoder;
+        typename Devices::AnalogInput *m_absoluteEncoder;
+
+        //Only the thread that owns the drivetrain changes the calibration
+        //below (see BasicSwerveTrain::updateCommands()), but the steering
+        //thread reads the zero, so it is never torn.
+        std::atomic<double> m_swerveZeroPosition;
+        std::string m_zeroOffsetKey;
+        double m_zeroOffset;
+        bool m_zeroOffsetKnown;
+        double m_steeringDrift;
 };
+
+using SwerveModule = BasicSwerveModule<RevDevices>;
@@ -1,12 +1,19 @@
 /*
-class SwerveTrain
+class BasicSwerveTrain<Devices>
 
-    Allows higher-level control of four SwerveModules as a drivetrain, and
-        provides many private controller functions for manipulating it.
+    Usually used as SwerveTrain, which is built on RevDevices. See Devices.h.
+
+    Allows higher-level control of four SwerveModules as a drivetrain.
+        Everything that moves the whole robot goes through drive(), so the
+        controller functions are only a thin layer over DriveInput.h.
+        Whatever wants to drive (the controller functions, Hal) does not
+        call drive() itself, though: it submits a DriveCommand, from
+        whichever thread it runs on, and updateCommands() picks between
+        them and drives, from the one thread that owns the drivetrain.
 
 Constructors
 
-    SwerveTrain(SwerveModule&, SwerveModule&, SwerveModule&, SwerveModule&, NavX&)
+    BasicSwerveTrain(BasicSwerveModule&, BasicSwerveModule&, BasicSwerveModule&, BasicSwerveModule&, BasicNavX&)
         Creates a swerve train with the swerve modules on the front right,
         front left, back left, and back right positions, and takes a NavX
         for use in calculating rotational vectors.
@@ -15,8 +22,13 @@ Public Methods
 
     void setDriveSpeed(const double&)
         Sets a speed to the driving motors on the train. Defaults to zero.
+        Since that is not through drive(), its setpoint starts again from
+        stopped.
     void setSwerveSpeed(const double&)
         Sets a speed to all swerve motors on the train. Defaults to zero.
+        Like everything else that turns the swerves, hands it to
+        updateSteering() to set, in place of whatever drive() last aimed
+        at, so only called from the thread that owns the drivetrain.
     void setDriveBrake(const double&)
         If true, sets the drives to brake mode (as defaultly constructed),
         if false, sets them to coast. Persists across calls. This is used in
@@ -25,15 +37,27 @@ Public Methods
         Same as above for swerve. This is used to
         "unlock and lock" all of the swerve wheels for easy manual zeroing,
         instead of fighting the wheel brake as defaultly constructed.
-    void setZeroPosition(const bool& = false)
+    bool setZeroPosition()
         Gets the current encoder values of the swerve motors and stores them
         as privates of the class. These are the values the swerve motors return
         to when invoking assumeSwerveZeroPosition().
-        If the passed bool is true, publishes the stored data to the
-        SmartDashboard. This is currently used for returning to and maintaining
-        "straight".
+        This is currently used for returning to and maintaining "straight".
+        The steering thread reads the zeros, and the drive thread corrects
+        them for drift, so this only submits a command for updateCommands()
+        to carry out on the drive thread, and returns false if it could not.
+        Called from any thread.
+    bool loadZeroPosition()
+        Same as above, to load each module's zero position from its absolute
+        encoder and saved offset, or set it where it is if it has none. See
+        SwerveModule.h.
+    bool saveZeroPosition()
+        Same as above, to save each module's zero position against its
+        absolute encoder, so that loadZeroPosition() finds it again after a
+        power cycle.
     void assumeZeroPosition()
-        Drives the swerves to return to their zero position.
+        Drives the swerves to return to their zero position. Like the rest
+        of what turns the swerves, only called from the thread that owns the
+        drivetrain; anything else submits a kStraighten command.
     void assumeNearestZeroPosition()
         Drives the swerves to the nearest Nic's Constant multiple of its zero
         value, CW or CCW. In doing so, really only drives the swerve to either
@@ -42,69 +66,197 @@ Public Methods
         way possible, making use of getSwervePositionSingleRotation() as
         the driver function to make this possible. assumeSwerveZeroPosition()
         cannot make this optimization, and simply goes to whatever the zero
-        value is. Useful for low-level things.
+        value is. Useful for low-level things. Same threading as above.
+    void updateSteering()
+        Steers the swerves toward the targets drive() last set, or holds the
+        speed setSwerveSpeed() last set, so that they can be steered more
+        often than the main loop drives (see Scheduler.h). It is the only
+        thing that sets the swerves' outputs, so nothing can overwrite a
+        stop. If no new targets come for R_swerveTrainSteeringTimeout loops,
+        the drivetrain's thread has stopped, so it stops the swerves once
+        rather than leave them turning. Only ever called from one thread,
+        which need not be the one calling drive(), as the targets are
+        handed over through a TripleBuffer.
+    void updateState()
+        Takes a snapshot of the swerve train's State, for
+        publishSwervePositions() to read from another thread without either
+        waiting on the other. Only ever called from one thread.
     void publishSwervePositions()
-        Puts the current swerve encoder positions to the SmartDashboard.
-    void driveController(frc::Joystick *controller)
-        Fully drives the swerve train on the supplied controller.
-    void driveControllerPrecision(frc::Joystick *controller)
-        Same as above, but scales all values according to a R_ constant
-        and doesn't re-center after maneuvering to allow for slow, incredibly
-        precise positioning by hand in the full range of the controller.
-    void zeroController(frc::Joystick *controller)
+        Puts the swerve positions, their zeros, and how far each has
+        drifted, as of the last updateState(), to the SmartDashboard. Only
+        ever called from one thread.
+    struct State
+        The swerve positions, their zeros, and their drift (front right,
+        front left, rear left, then rear right), and the setpoint, all from
+        the same loop.
+    bool getStationary()
+        Returns true if every drive wheel is slower than
+        R_zionStationaryMaxVelocity, for the NavX's updateBias().
+    void updateSteeringDrift()
+        Checks every module for drift (see SwerveModule.h). Those without an
+        absolute encoder are checked against where the other wheels and the
+        NavX say the robot is going. Called by drive() every loop.
+    bool submit(const DriveCommand&)
+        Queues the supplied command for updateCommands(). Returns false if
+        too many are already waiting (see R_driveCommandQueueSize). Called
+        from any thread.
+    void updateCommands()
+        Takes every command submitted since the last call, and carries out
+        whichever still stands (see R_driveCommandTimeout) with the highest
+        priority, the newest of them if tied. Once none stands, stops once
+        and leaves Zion stopped.
+        A command to stop likewise stands only until Zion has, and one to
+        stop dead (see DriveCommand.h) only for the one call. Calibrations
+        are carried out as they come, and stand for nothing. Only ever
+        called from the thread that owns the drivetrain, which is the only
+        one that may call drive() or change the zero positions.
+    bool getPointed(const double&)
+        Returns true if a kPoint or kStraighten command made at or after the
+        supplied time (see DriveCommand::now()) has had every swerve within
+        R_swerveTrainAssumePositionTolerance of where it pointed them. How
+        Hal waits for the swerves without turning them itself. Called from
+        any thread.
+    void drive(const ChassisSpeeds&, const bool& = true, const Vec2d& = {0, 0})
+        Drives the swerve train at the supplied speeds. If the bool is true
+        they are relative to the field (forward is away from the operator,
+        by the NavX), otherwise to the robot. Each loop, only goes as far
+        toward them as every module can follow (see limitSetpoint()), and
+        drives each module only as much as it points where it should. The
+        robot turns about the supplied center of rotation, in meters to the
+        right and forward of its center (see getCenterOfRotation()), and the
+        speeds are those of the robot's center. Speeds of zero stop both the
+        drives and the swerves where they are.
+    void driveController(const ControllerState &controller, const Vec2d& = {0, 0}, const double& = R_executionCapZion)
+        Fully drives the swerve train on the supplied controller, relative to
+        the field, turning about the supplied center of rotation, by
+        submitting a teleop command. The stick is shaped by a
+        DriveInput::Shaper and scaled by the supplied execution cap, so a
+        lower one (like R_executionCapZionPrecision) allows for slow,
+        incredibly precise positioning by hand in the full range of the
+        controller. When the controller is still, either stops with the
+        swerves where they are or submits a kStraighten command to return
+        them to zero, by R_zionIdleAssumeZeroPosition.
+    void calculateModuleTargets(const double&, const double&, const double&, const double&, double[4], double[4], const double& = 0, const double& = 0, double[4] = nullptr, const Vec2d& = {0, 0})
+        Does the math behind drive(): from an X (inverted, so positive is
+        left), Y, and Z as fractions of full speed, and the yaw from the
+        NavX (or zero, relative to the robot), fills in the swerve position
+        (in Nics) and the drive speed (as a fraction of full speed) for each
+        module, front right, front left, rear left, then rear right. Public
+        so that its results can be checked by GoldenCheck. If the rate the
+        heading is turning (in degrees per second counterclockwise, as the
+        upside-down NavX counts it and getHeadingRate() returns it) and the
+        period the targets will be held for (in seconds) are also supplied,
+        the targets are for the whole period rather than the instant: the
+        robot ends the period where it would have with no turn instead of
+        on an arc. The last array, if supplied, is filled in with
+        how fast each position moves as the robot turns, in Nics per second,
+        for assumeSwervePosition() to keep up with. The last vector is the
+        center of rotation, as in drive().
+    void desaturateModuleSpeeds(double[4], const double&)
+        Scales the four supplied module speeds down together, if any is
+        faster than the supplied maximum, so that the fastest is exactly the
+        maximum. Their ratios are kept, so the robot still translates and
+        rotates in the commanded proportions, only slower, rather than
+        arcing when one wheel is clamped. Any units work as long as both
+        match.
+    void zeroController(const ControllerState &controller)
         Allows use of a controller through a mapped button which is held down
         in correspondence to a motor to slowly override its zero from that
         controller's joystick value. This allows manual adjustment from an
-        enabled state in case of either drift or error.
-        TODO: CURRENTLY WRITTEN FOR A JOYSTICK, WILL NEED TO CHANGE.
-    double getClockwiseREVRotationsFromCenter(frc::Joystick*)
+        enabled state in case of either drift or error. The swerve is
+        turned by submitting kNudge commands while the button is held, and
+        once it is released, Zion stops and the zeros are set where the
+        swerves are (see setZeroPosition()). Pressing the save button saves
+        the zeros (see saveZeroPosition()), so calibrating once in test mode
+        lasts until the modules are taken apart.
+    Vec2d getCenterOfRotation(const int&)
+        Returns the center of rotation for one of the supplied
+        CentersOfRotation, for drive().
+    double getClockwiseREVRotationsFromCenter(const ControllerState&)
         Discernes how many clockwise REV rotations from center the current
-        location of the joystick is using vector trigonometry and properties.
-        See https://en.wikipedia.org/wiki/Dot_product#Geometric_definition
+        location of the joystick is. See Angle.h.
+
+    enum CentersOfRotation
+        Points worth turning about: kCenter, or the corner of the bumpers at
+        kFrontLeftBumper, kFrontRightBumper, kRearLeftBumper, or
+        kRearRightBumper, for pivoting around a defender or along a wall.
 
 Private Methods
 
-    double getClockwiseREVRotationsFromCenter(const VectorDouble&)
+    double getClockwiseREVRotationsFromCenter(const Vec2d&)
         Same as above, but accepts a vector outright instead of stripping
         one from the supplied controller.
     double getStandardDegreeAngleFromCenter(const double&, const double&)
-        Same as above, but returns the result as a degree measure in standard
-        position.
+        Same as above, but returns the result as a degree measure clockwise
+        from center.
     double getLargestMagnitudeValue(const double&, const double&, const double&, const double&)
         Returns the largest of the four values passed to the function.
-    double getControllerAbsoluteMagnitude(frc::Joystick*)
-        Gets the unsigned velocity of the control stick using only absolute
-        value.
-    bool getControllerInDeadzone(frc::Joystick*)
-        If all axis of the controller are within their RobotMap deadzone
-        variables for playerOne's controller, returns true; otherwise, returns
-        false.
-    void forceControllerXYZToZeroInDeadzone(const int&, const int&, const int&)
-        If any of the passed X, Y, or Z values fall outside of their global
-        deadzone, they will be set to 0. Otherwise, they are untouched.
-    void optimizeControllerXYToZ(const double&, const double&, double &)
-        Scales the value of Z with a propotion constant to the magnitude of
-        X and Y. Makes rotation harder to incude as speed increases, which
-        makes strafing with a joystick much more reliable.
+    void driveModules(const double&, const double&, const double&, const double&, const Vec2d&)
+        Calculates the module targets for the supplied X, Y, Z, yaw, and
+        center of rotation over one loop, assumes their positions, and
+        drives at their speeds in R_zionDriveMaxVelocitys, desaturated to
+        R_zionMaxModuleSpeed.
+    void pointModules(const ChassisSpeeds&)
+        Stops the drives and steers every swerve the way the supplied speeds,
+        relative to the robot, would translate it, or straight if they do
+        not translate it, for kPoint and kStraighten commands. Hands the
+        position to updateSteering() in place of what drive() last aimed
+        at, and records when the swerves get there for getPointed().
+    void setSwerveSpeeds(const double[4])
+        Same as setSwerveSpeed(), with a speed for each module, front right,
+        front left, rear left, then rear right, for kNudge commands.
+    bool calibrate(const int&)
+        Carries out the supplied DriveCommand::Actions on every module if it
+        is a calibration, and returns true; otherwise, returns false.
+    ChassisSpeeds limitSetpoint(const ChassisSpeeds&, const Vec2d&)
+        The setpoint generator. Returns the speeds (relative to the robot)
+        furthest along the way from the last setpoint to the supplied ones
+        that no module, turning about the supplied center of rotation, has
+        to accelerate faster than R_zionSetpointMaxDriveAcceleration or
+        steer faster than R_zionSetpointMaxSteeringRate to reach in one
+        loop.
+    bool getSetpointReachable(const ChassisSpeeds&, const Vec2d&, const double[4], const double[4])
+        Returns true if the modules can get from the supplied last positions
+        (in Nics) and speeds (in meters per second) to the supplied speeds
+        in one loop.
+    void getModuleSetpoints(const ChassisSpeeds&, const Vec2d&, double[4], double[4])
+        Fills in the position in Nics and the desaturated speed in meters
+        per second of each module for the supplied speeds, relative to the
+        robot, at an instant.
+    void getKinematicInputs(const ChassisSpeeds&, double&, double&, double&)
+        Fills in the X, Y, and Z calculateModuleTargets() takes for the
+        supplied speeds.
+    double getHeadingRate(const double&, const double[4])
+        Returns how fast, in degrees per second counterclockwise (as the
+        upside-down NavX counts it), the supplied Z turns the robot, given
+        the module speeds it comes with.
 */
 
 #pragma once
 
 #include <math.h>
 
-#include <frc/Joystick.h>
-#include <frc/smartdashboard/SmartDashboard.h>
+#include <atomic>
+#include <string>
 
-#include "rev/CANSparkMax.h"
+#include <frc/smartdashboard/SmartDashboard.h>
 
+#include "ChassisSpeeds.h"
+#include "CommandQueue.h"
+#include "Controllers.h"
+#include "Devices.h"
+#include "DriveCommand.h"
+#include "DriveInput.h"
 #include "NavX.h"
 #include "SwerveModule.h"
-#include "VectorDouble.h"
+#include "TripleBuffer.h"
+#include "Vec2.h"
 
-class SwerveTrain {
+template <class Devices>
+class BasicSwerveTrain {
 
     public:
-        SwerveTrain(SwerveModule &frontRightModule, SwerveModule &frontLeftModule, SwerveModule &rearLeftModule, SwerveModule &rearRightModule, NavX &navXToSet) {
+        BasicSwerveTrain(BasicSwerveModule<Devices> &frontRightModule, BasicSwerveModule<Devices> &frontLeftModule, BasicSwerveModule<Devices> &rearLeftModule, BasicSwerveModule<Devices> &rearRightModule, BasicNavX<Devices> &navXToSet) {
 
             m_frontRight = &frontRightModule;
             m_frontLeft = &frontLeftModule;
@@ -119,13 +271,12 @@ class SwerveTrain {
             m_frontLeft->setDriveSpeed(driveSpeed);
             m_rearLeft->setDriveSpeed(driveSpeed);
             m_rearRight->setDriveSpeed(driveSpeed);
+            m_setpoint = {0, 0, 0};
         }
         void setSwerveSpeed(const double &swerveSpeed = 0) {
 
-            m_frontRight->setSwerveSpeed(swerveSpeed);
-            m_frontLeft->setSwerveSpeed(swerveSpeed);
-            m_rearLeft->setSwerveSpeed(swerveSpeed);
-            m_rearRight->setSwerveSpeed(swerveSpeed);
+            const double swerveSpeeds[4] = {swerveSpeed, swerveSpeed, swerveSpeed, swerveSpeed};
+            setSwerveSpeeds(swerveSpeeds);
         }
         void setDriveBrake(const bool &brake) {
 
@@ -142,125 +293,204 @@ class SwerveTrain {
             m_rearRight->setSwerveBrake(brake);
         }
 
-        void setZeroPosition(const bool &verbose = false) {
+        bool setZeroPosition() {
 
-            m_frontRight->setZeroPosition();
-            m_frontLeft->setZeroPosition();
-            m_rearLeft->setZeroPosition();
-            m_rearRight->setZeroPosition();
+            return submit(DriveCommand::fromAction(DriveCommand::kTeleop, DriveCommand::kSetZeroPosition));
+        }
+        bool loadZeroPosition() {
 
-            if (verbose) {
+            return submit(DriveCommand::fromAction(DriveCommand::kTeleop, DriveCommand::kLoadZeroPosition));
+        }
+        bool saveZeroPosition() {
 
-                frc::SmartDashboard::PutNumber("Zion::Swerve::0PosFR", m_frontRight->getSwerveZeroPosition());
-                frc::SmartDashboard::PutNumber("Zion::Swerve::0PosFL", m_frontLeft->getSwerveZeroPosition());
-                frc::SmartDashboard::PutNumber("Zion::Swerve::0PosRL", m_rearLeft->getSwerveZeroPosition());
-                frc::SmartDashboard::PutNumber("Zion::Swerve::0PosRR", m_rearRight->getSwerveZeroPosition());
-            }
+            return submit(DriveCommand::fromAction(DriveCommand::kTeleop, DriveCommand::kSaveZeroPosition));
         }
         void assumeZeroPosition() {
 
-            m_frontRight->assumeSwerveZeroPosition();
-            m_frontLeft->assumeSwerveZeroPosition();
-            m_rearLeft->assumeSwerveZeroPosition();
-            m_rearRight->assumeSwerveZeroPosition();
-        }
-        void assumeNearestZeroPosition() {
+            SteeringTargets targets{};
+            targets.steer = true;
+            BasicSwerveModule<Devices> *modules[4] = {m_frontRight, m_frontLeft, m_rearLeft, m_rearRight};
+            for (int module = 0; module < 4; module++) {
 
-            m_frontRight->assumeSwerveNearestZeroPosition();
-            m_frontLeft->assumeSwerveNearestZeroPosition();
-            m_rearLeft->assumeSwerveNearestZeroPosition();
-            m_rearRight->assumeSwerveNearestZeroPosition();
+                targets.positions[module] = modules[module]->getSwerveZeroPosition();
+            }
+            writeSteeringTargets(targets);
         }
+        void assumeNearestZeroPosition() {
 
-        void publishSwervePositions() {
+            SteeringTargets targets{};
+            targets.steer = true;
+            BasicSwerveModule<Devices> *modules[4] = {m_frontRight, m_frontLeft, m_rearLeft, m_rearRight};
+            for (int module = 0; module < 4; module++) {
 
-            frc::SmartDashboard::PutNumber("Zion::Swerve::PosFR", m_frontRight->getSwervePosition());
-            frc::SmartDashboard::PutNumber("Zion::Swerve::PosFL", m_frontLeft->getSwervePosition());
-            frc::SmartDashboard::PutNumber("Zion::Swerve::PosRL", m_rearLeft->getSwervePosition());
-            frc::SmartDashboard::PutNumber("Zion::Swerve::PosRR", m_rearRight->getSwervePosition());
+                targets.positions[module] = modules[module]->getSwerveNearestZeroPosition();
+            }
+            writeSteeringTargets(targets);
         }
 
-        void driveController(frc::Joystick *controller);
-        void driveControllerPrecision(frc::Joystick *controller); 
-        void zeroController(frc::Joystick *controller);
+        struct State {
 
-    private:
+            double swervePositions[4];
+            double swerveZeroPositions[4];
+            double steeringDrift[4];
+            ChassisSpeeds setpoint;
+        };
 
-        double getClockwiseREVRotationsFromCenter(frc::Joystick *controller);
-    public:
+        void updateSteering();
+        void updateState() {
 
-        //This is very useful in accurate auto positioning, so it is
-        //overriden public, specifically for Hal pass use at a low level.
-        double getClockwiseREVRotationsFromCenter(const VectorDouble &vector);
-    private:
+            State state;
+            BasicSwerveModule<Devices> *modules[4] = {m_frontRight, m_frontLeft, m_rearLeft, m_rearRight};
+            for (int module = 0; module < 4; module++) {
 
-        double getStandardDegreeAngleFromCenter(const double &x, const double &y);
-        double getLargestMagnitudeValue(const double &frVal, const double &flVal, const double &rlVal, const double &rrVal) {
+                state.swervePositions[module] = modules[module]->getSwervePosition();
+                state.swerveZeroPositions[module] = modules[module]->getSwerveZeroPosition();
+                state.steeringDrift[module] = modules[module]->getSteeringDrift();
+            }
+            state.setpoint = m_setpoint;
+            m_state.write(state);
+        }
+        void publishSwervePositions() {
 
-            return std::max(std::max(frVal, flVal), std::max(rrVal, rlVal));
+            const State &state = m_state.read();
+            const char *names[4] = {"FR", "FL", "RL", "RR"};
+            for (int module = 0; module < 4; module++) {
+
+                frc::SmartDashboard::PutNumber(std::string("Zion::Swerve::Pos") + names[module], state.swervePositions[module]);
+                frc::SmartDashboard::PutNumber(std::string("Zion::Swerve::0Pos") + names[module], state.swerveZeroPositions[module]);
+                frc::SmartDashboard::PutNumber(std::string("Zion::Swerve::Drift") + names[module], state.steeringDrift[module]);
+            }
         }
 
-        double getControllerAbsoluteMagnitude(frc::Joystick *controller) {
+        bool submit(const DriveCommand &command) {
 
-            //Get the absolute values of the joystick coordinates
-            double absX = abs(controller->GetX());
-            double absY = abs(controller->GetY());
+            return m_commands.push(command);
+        }
+        void updateCommands();
+        bool getPointed(const double &since) {
 
-            //Return the sum of the coordinates as a knock-off magnitude
-            return absX + absY;
+            return m_pointedTimestamp.load() >= since;
         }
-        bool getControllerInDeadzone(frc::Joystick *controller) {
+        void drive(const ChassisSpeeds &speeds, const bool &fieldRelative = true, const Vec2d &centerOfRotation = {0, 0});
+        void driveController(const ControllerState &controller, const Vec2d &centerOfRotation = {0, 0}, const double &executionCap = R_executionCapZion);
+        void calculateModuleTargets(const double &x, const double &y, const double &z, const double &angle, double positions[4], double speeds[4], const double &headingRate = 0, const double &period = 0, double positionRates[4] = nullptr, const Vec2d &centerOfRotation = {0, 0});
+        void desaturateModuleSpeeds(double speeds[4], const double &maxSpeed) {
 
-            const double absX = abs(controller->GetX());
-            const double absY = abs(controller->GetY());
-            const double absZ = abs(controller->GetZ());
-            const double zone = R_deadzoneController;
+            const double largestSpeed = getLargestMagnitudeValue(fabs(speeds[0]), fabs(speeds[1]), fabs(speeds[2]), fabs(speeds[3]));
+            if (largestSpeed > maxSpeed) {
 
-            if (absX < zone && absY < zone && absZ < zone) {
+                for (int module = 0; module < 4; module++) {
 
-                return true;
+                    speeds[module] *= maxSpeed / largestSpeed;
+                }
             }
-            return false;
         }
-        void forceControllerXYZToZeroInDeadzone(double &x, double &y, double &z) {
-
-            double absX = abs(x);
-            double absY = abs(y);
-            double absZ = abs(z);
+        bool getStationary() {
 
-            if (absX < R_deadzoneController) {x = 0;}
-            if (absY < R_deadzoneController) {y = 0;}
-            if (absZ < R_deadzoneController) {z = 0;}
+            return fabs(m_frontRight->getDriveVelocity()) < R_zionStationaryMaxVelocity &&
+                   fabs(m_frontLeft->getDriveVelocity()) < R_zionStationaryMaxVelocity &&
+                   fabs(m_rearLeft->getDriveVelocity()) < R_zionStationaryMaxVelocity &&
+                   fabs(m_rearRight->getDriveVelocity()) < R_zionStationaryMaxVelocity;
         }
-        //TODO: Inline function documentation
-        void optimizeControllerXYToZ(const double &x, const double &y, double &z) {
+        void updateSteeringDrift();
+        void zeroController(const ControllerState &controller);
+        Vec2d getCenterOfRotation(const int &center);
 
-            double magnitudeXY = sqrt(x * x + y * y);
-            double absZ = abs(z);
-            double deadzoneAdjustmentZ = R_deadzoneControllerZ + .3 * magnitudeXY * R_deadzoneControllerZ;
+        enum CentersOfRotation {
 
-            if (z > deadzoneAdjustmentZ) {
+            kCenter, kFrontLeftBumper, kFrontRightBumper, kRearLeftBumper, kRearRightBumper
+        };
 
-                z -= (deadzoneAdjustmentZ - R_deadzoneController);
-            }
-            else if (z < -deadzoneAdjustmentZ) {
+    private:
 
-                z += (deadzoneAdjustmentZ - R_deadzoneController);
-            }
-            if (absZ < deadzoneAdjustmentZ) {
+        double getClockwiseREVRotationsFromCenter(const ControllerState &controller);
+    public:
 
-                z = 0;
+        //This is very useful in accurate auto positioning, so it is
+        //overriden public, specifically for Hal pass use at a low level.
+        double getClockwiseREVRotationsFromCenter(const Vec2d &vector);
+    private:
+
+        friend class Benchmark;
+        friend class GoldenCheck;
+
+        double getStandardDegreeAngleFromCenter(const double &x, const double &y);
+        void driveModules(const double &x, const double &y, const double &z, const double &angle, const Vec2d &centerOfRotation);
+        ChassisSpeeds limitSetpoint(const ChassisSpeeds &speeds, const Vec2d &centerOfRotation);
+        bool getSetpointReachable(const ChassisSpeeds &speeds, const Vec2d &centerOfRotation, const double lastPositions[4], const double lastSpeeds[4]);
+        void getModuleSetpoints(const ChassisSpeeds &speeds, const Vec2d &centerOfRotation, double positions[4], double moduleSpeeds[4]);
+        void pointModules(const ChassisSpeeds &speeds);
+        bool calibrate(const int &action);
+        void getKinematicInputs(const ChassisSpeeds &speeds, double &x, double &y, double &z);
+        double getHeadingRate(const double &z, const double speeds[4]);
+        double getLargestMagnitudeValue(const double &frVal, const double &flVal, const double &rlVal, const double &rrVal) {
+
+            return std::max(std::max(frVal, flVal), std::max(rrVal, rlVal));
+        }
+
+        //The speeds, relative to the robot, the modules were last sent to.
+        ChassisSpeeds m_setpoint{0, 0, 0};
+        //What the swerves were last told to do, handed to the steering
+        //thread, which is the only one that sets their outputs: steer
+        //toward positions, moving at rates, or if steer is false, hold
+        //speeds (zero to stop them)...
+        struct SteeringTargets {
+
+            double positions[4];
+            double rates[4];
+            bool steer;
+            double speeds[4];
+            //One more than the last targets', so that updateSteering() can
+            //tell new targets from the same ones read again.
+            unsigned generation;
+        };
+        void setSwerveSpeeds(const double swerveSpeeds[4]) {
+
+            SteeringTargets targets{};
+            targets.steer = false;
+            for (int module = 0; module < 4; module++) {
+
+                targets.speeds[module] = swerveSpeeds[module];
             }
+            writeSteeringTargets(targets);
         }
+        void writeSteeringTargets(SteeringTargets &targets) {
+
+            targets.generation = ++m_steeringTargetsWritten;
+            m_steeringTargets.write(targets);
+        }
+        TripleBuffer<SteeringTargets> m_steeringTargets;
+        unsigned m_steeringTargetsWritten = 0;
+        //And, on the steering thread, the last targets it read, how many
+        //more times it may carry them out, and whether it has stopped the
+        //swerves since.
+        unsigned m_steeringTargetsRead = 0;
+        int m_steeringLoopsRemaining = 0;
+        bool m_steeringStopped = true;
+        //When the command that last got the swerves where pointModules()
+        //pointed them was made, for getPointed().
+        std::atomic<double> m_pointedTimestamp{0};
+        //And the snapshot for whatever publishes it.
+        TripleBuffer<State> m_state;
+        //The commands submitted to the drivetrain, and the one it is
+        //carrying out, if any.
+        CommandQueue<DriveCommand, R_driveCommandQueueSize> m_commands;
+        DriveCommand m_command;
+        bool m_commandHeld = false;
+        //How the driver's stick is shaped, which remembers where it was.
+        DriveInput::Shaper m_driverInput;
 
     //Allow the peices of the SwerveTrain to be public for convenient
     //low-level access when needed. SwerveTrain is a great container.
-    //This is primarily used for Hal, the auto driver, so he can set low-level
-    //module commands through one passed SwerveTrain.
+    //This is primarily used for Hal, the auto driver, so he can read the
+    //modules through one passed SwerveTrain. Moving or pointing anything
+    //goes through submit() instead.
     public:
-        SwerveModule *m_frontRight;
-        SwerveModule *m_frontLeft;
-        SwerveModule *m_rearLeft;
-        SwerveModule *m_rearRight;
-        NavX *navX;
+        BasicSwerveModule<Devices> *m_frontRight;
+        BasicSwerveModule<Devices> *m_frontLeft;
+        BasicSwerveModule<Devices> *m_rearLeft;
+        BasicSwerveModule<Devices> *m_rearRight;
+        BasicNavX<Devices> *navX;
 };
+
+using SwerveTrain = BasicSwerveTrain<RevDevices>;
@@ -0,0 +1,79 @@
+/*
+class TripleBuffer<T>
+
+    Hands the latest copy of some state (usually a small struct of plain
+        values) from the one thread that writes it to the one thread that
+        reads it, without either ever waiting on the other. There are three
+        copies: one the writer fills, one the reader holds, and one in the
+        middle holding the newest finished write. Writing finishes by
+        swapping the filled copy into the middle, and reading starts by
+        swapping the middle out, if it is newer, each with one atomic
+        exchange. The reader therefore always sees a whole write (never half
+        of one and half of the next), and the latest whole one.
+
+    Only one thread may write and only one may read. Anything shared more
+    widely than that needs one buffer per reader.
+
+Constructors
+
+    TripleBuffer()
+        Creates a buffer holding three default constructed copies.
+    TripleBuffer(const T&)
+        Creates a buffer holding three copies of the supplied state, so
+        that reads before the first write return it.
+
+Public Methods
+
+    void write(const T&)
+        Publishes the supplied state. Called only from the writing thread.
+    const T &read()
+        Returns the latest published state, which stays as it is until the
+        next read. Called only from the reading thread.
+    bool getFresh()
+        Returns true if there has been a write since the last read.
+*/
+
+#pragma once
+
+#include <atomic>
+
+template <typename T>
+class TripleBuffer {
+
+    public:
+        TripleBuffer() : m_buffers{} {}
+        TripleBuffer(const T &initial) : m_buffers{initial, initial, initial} {}
+
+        void write(const T &state) {
+
+            m_buffers[m_back] = state;
+            //The one being swapped out of the middle is either stale or was
+            //never read, so it is the writer's to overwrite next.
+            m_back = m_middle.exchange(m_back | kFresh, std::memory_order_acq_rel) & kIndex;
+        }
+        const T &read() {
+
+            //Only take the middle if something new is in it; otherwise the
+            //one already held is the latest.
+            if (m_middle.load(std::memory_order_relaxed) & kFresh) {
+
+                m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & kIndex;
+            }
+            return m_buffers[m_front];
+        }
+        bool getFresh() {
+
+            return m_middle.load(std::memory_order_relaxed) & kFresh;
+        }
+
+    private:
+        //The middle holds the index of its copy in its low bits, and whether
+        //it has been written since it was last read in the next one up.
+        static constexpr int kIndex = 3;
+        static constexpr int kFresh = 4;
+
+        T m_buffers[3];
+        int m_back = 0;
+        std::atomic<int> m_middle{1};
+        int m_front = 2;
+};
@@ -0,0 +1,236 @@
+/*
+struct Vec2<T>
+
+    A 2D vector A<i,j> of floats or doubles (Vec2f and Vec2d). It is a plain
+        aggregate, so it is trivially copyable, is built with braces
+        (Vec2d vector{i, j}), and everything but the norm is constexpr, so
+        constant vectors cost nothing at runtime.
+
+Public Methods
+
+    Vec2 operator+, operator- (const Vec2&)
+    Vec2 operator- ()
+    Vec2 operator*, operator/ (const T&)
+        Add, subtract, negate, and scale. A scalar may also be on the left
+        of *. Each has a compound assignment (+=, -=, *=) as well.
+    bool operator==, operator!= (const Vec2&)
+    T dot(const Vec2&)
+        Returns the dot product.
+    T cross(const Vec2&)
+        Returns the Z component of the cross product, which is positive when
+        the other vector is counterclockwise from this one.
+    Vec2 rotate(const T&, const T&)
+        Returns the vector rotated counterclockwise by the angle whose cosine
+        and sine are supplied. Taking sin() and cos() once and rotating many
+        vectors by them is much cheaper than taking them for each vector.
+    Vec2 perpendicular()
+        Returns the vector rotated a quarter turn clockwise.
+    T normSquared()
+    T norm()
+        Return the squared length and the length. The norm uses hypot(),
+        which never overflows or underflows in the middle of the math.
+    Vec2 normalize()
+        Returns the vector scaled to a length of one, or the zero vector if
+        it has no length.
+
+struct Vec2x4
+
+    Four Vec2fs, one for each swerve module, with each component stored as a
+        Float4 (see Simd.h) so that all four are operated on at once. Has the
+        same operators as Vec2, with scalars as either a float for all four
+        lanes or a Float4 for each of them, and dot(), cross(), normSquared(),
+        and norm() return a Float4 of the four results.
+
+    static Vec2x4 load(const Vec2f[4])
+        Returns the four supplied vectors in lanes 0 through 3.
+    void store(Vec2f[4])
+        Writes the four lanes back out as vectors.
+*/
+
+#pragma once
+
+#include <math.h>
+
+#include "Simd.h"
+
+template <typename T>
+struct Vec2 {
+
+        constexpr Vec2 operator+ (const Vec2 &other) const {
+
+            return {i + other.i, j + other.j};
+        }
+        constexpr Vec2 operator- (const Vec2 &other) const {
+
+            return {i - other.i, j - other.j};
+        }
+        constexpr Vec2 operator- () const {
+
+            return {-i, -j};
+        }
+        constexpr Vec2 operator* (const T &scalar) const {
+
+            return {i * scalar, j * scalar};
+        }
+        constexpr Vec2 operator/ (const T &scalar) const {
+
+            return {i / scalar, j / scalar};
+        }
+        constexpr Vec2 &operator+= (const Vec2 &other) {
+
+            i += other.i;
+            j += other.j;
+            return *this;
+        }
+        constexpr Vec2 &operator-= (const Vec2 &other) {
+
+            i -= other.i;
+            j -= other.j;
+            return *this;
+        }
+        constexpr Vec2 &operator*= (const T &scalar) {
+
+            i *= scalar;
+            j *= scalar;
+            return *this;
+        }
+        constexpr bool operator== (const Vec2 &other) const {
+
+            return i == other.i && j == other.j;
+        }
+        constexpr bool operator!= (const Vec2 &other) const {
+
+            return !(*this == other);
+        }
+
+        constexpr T dot(const Vec2 &other) const {
+
+            return (i * other.i) + (j * other.j);
+        }
+        constexpr T cross(const Vec2 &other) const {
+
+            return (i * other.j) - (j * other.i);
+        }
+        constexpr Vec2 rotate(const T &cosine, const T &sine) const {
+
+            return {i * cosine - j * sine, i * sine + j * cosine};
+        }
+        constexpr Vec2 perpendicular() const {
+
+            return {j, -i};
+        }
+        constexpr T normSquared() const {
+
+            return dot(*this);
+        }
+        T norm() const {
+
+            return hypot(i, j);
+        }
+        Vec2 normalize() const {
+
+            const T length = norm();
+            return length == 0 ? Vec2{0, 0} : *this / length;
+        }
+
+        T i;
+        T j;
+};
+
+template <typename T>
+constexpr Vec2<T> operator* (const T &scalar, const Vec2<T> &vector) {
+
+    return vector * scalar;
+}
+
+using Vec2d = Vec2<double>;
+using Vec2f = Vec2<float>;
+
+struct Vec2x4 {
+
+        static Vec2x4 load(const Vec2f vectors[4]) {
+
+            const float iValues[4] = {vectors[0].i, vectors[1].i, vectors[2].i, vectors[3].i};
+            const float jValues[4] = {vectors[0].j, vectors[1].j, vectors[2].j, vectors[3].j};
+            return {Float4::load(iValues), Float4::load(jValues)};
+        }
+        void store(Vec2f vectors[4]) const {
+
+            float iValues[4];
+            float jValues[4];
+            i.store(iValues);
+            j.store(jValues);
+            for (int lane = 0; lane < 4; lane++) {
+
+                vectors[lane] = {iValues[lane], jValues[lane]};
+            }
+        }
+
+        Vec2x4 operator+ (const Vec2x4 &other) const {
+
+            return {i + other.i, j + other.j};
+        }
+        Vec2x4 operator- (const Vec2x4 &other) const {
+
+            return {i - other.i, j - other.j};
+        }
+        Vec2x4 operator- () const {
+
+            return {-i, -j};
+        }
+        Vec2x4 operator* (const Float4 &scalar) const {
+
+            return {i * scalar, j * scalar};
+        }
+        Vec2x4 operator* (const float &scalar) const {
+
+            return *this * Float4::broadcast(scalar);
+        }
+        Vec2x4 operator/ (const Float4 &scalar) const {
+
+            return {i / scalar, j / scalar};
+        }
+        Vec2x4 &operator+= (const Vec2x4 &other) {
+
+            *this = *this + other;
+            return *this;
+        }
+        Vec2x4 &operator-= (const Vec2x4 &other) {
+
+            *this = *this - other;
+            return *this;
+        }
+        Vec2x4 &operator*= (const Float4 &scalar) {
+
+            *this = *this * scalar;
+            return *this;
+        }
+
+        Float4 dot(const Vec2x4 &other) const {
+
+            return (i * other.i) + (j * other.j);
+        }
+        Float4 cross(const Vec2x4 &other) const {
+
+            return (i * other.j) - (j * other.i);
+        }
+        Vec2x4 rotate(const Float4 &cosine, const Float4 &sine) const {
+
+            return {i * cosine - j * sine, i * sine + j * cosine};
+        }
+        Vec2x4 perpendicular() const {
+
+            return {j, -i};
+        }
+        Float4 normSquared() const {
+
+            return dot(*this);
+        }
+        Float4 norm() const {
+
+            return Float4::sqrt(normSquared());
+        }
+
+        Float4 i;
+        Float4 j;
+};
@@ -0,0 +1,246 @@
+/*
+class Benchmark
+
+    Times the math at the heart of driving so that every optimization has a
+        number attached to it. Each measurement runs a function many times,
+        reports the average nanoseconds per call, and is stored so the whole
+        set can be written as JSON and compared against a stored baseline.
+
+    It drives a swerve train built on FakeDevices, so it is built with the
+    tests, for the desktop, and run by BenchmarkTest. Only ratios between
+    runs on the same machine mean anything. To store a baseline, run the
+    tests, and copy the benchmark.json they write (next to their results in
+    build/test-results) to src/test/cpp/benchmark-baseline.json.
+
+Constructors
+
+    Benchmark()
+        Creates a benchmark with no measurements.
+
+Public Methods
+
+    double measure(const std::string&, const int&, Function)
+        Calls the supplied function the supplied number of times, stores the
+        average nanoseconds per call under the supplied name, and returns it.
+        The function must return a double, which is kept so the compiler
+        cannot throw away the work.
+    void runDrivetrain(const ControllerState&)
+        Measures the angle conversions (with the standard arctangent, the
+        fast one, and Angle::atan2(), which picks between them, on their
+        own), Vec2 math (including all four modules at
+        once with Vec2x4), the swerve speed calculation, and full
+        driveController() iterations, through to the command it submits
+        being carried out, against a swerve train built on FakeDevices, so
+        no motor is ever driven.
+    const std::map<std::string, double> &getResults()
+        Returns every measurement, by name, in nanoseconds per call.
+    bool writeJson(const std::string&)
+        Writes every measurement to the supplied path as a JSON object of
+        names to nanoseconds per call. Returns false if it could not.
+    bool readBaseline(const std::string&)
+        Reads a JSON file written by writeJson() as the baseline to compare
+        against. Returns false if it could not.
+    double getRatio(const std::string&)
+        Returns the supplied measurement over its baseline (below 1 is
+        faster), or 0 if either does not exist.
+*/
+
+#pragma once
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Angle.h"
+#include "Controllers.h"
+#include "Devices.h"
+#include "FakeDevices.h"
+#include "NavX.h"
+#include "RobotMap.h"
+#include "SwerveModule.h"
+#include "SwerveTrain.h"
+#include "Vec2.h"
+
+class Benchmark {
+
+    public:
+        Benchmark() {
+
+            m_sink = 0;
+        }
+
+        template <typename Function>
+        double measure(const std::string &name, const int &iterations, Function function) {
+
+            double sum = 0;
+            const auto start = std::chrono::steady_clock::now();
+            for (int iteration = 0; iteration < iterations; iteration++) {
+
+                sum += function(iteration);
+            }
+            const auto end = std::chrono::steady_clock::now();
+            m_sink = m_sink + sum;
+
+            const double nanosecondsPerCall = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+            m_results[name] = nanosecondsPerCall;
+            return nanosecondsPerCall;
+        }
+        void runDrivetrain(const ControllerState &controller) {
+
+            const int iterations = 10000;
+
+            BasicNavX<FakeDevices> navX(BasicNavX<FakeDevices>::kMXP);
+            BasicSwerveModule<FakeDevices> frontRight(R_CANIDZionFrontRightDrive, R_CANIDZionFrontRightSwerve);
+            BasicSwerveModule<FakeDevices> frontLeft(R_CANIDZionFrontLeftDrive, R_CANIDZionFrontLeftSwerve);
+            BasicSwerveModule<FakeDevices> rearLeft(R_CANIDZionRearLeftDrive, R_CANIDZionRearLeftSwerve);
+            BasicSwerveModule<FakeDevices> rearRight(R_CANIDZionRearRightDrive, R_CANIDZionRearRightSwerve);
+            BasicSwerveTrain<FakeDevices> zion(frontRight, frontLeft, rearLeft, rearRight, navX);
+
+            //Sweep the inputs around the circle so every quadrant (and every
+            //branch) is exercised, rather than timing one lucky value. These
+            //are worked out ahead of time so their cost is not measured.
+            std::vector<double> sweepX(iterations);
+            std::vector<double> sweepY(iterations);
+            for (int iteration = 0; iteration < iterations; iteration++) {
+
+                sweepX[iteration] = cos(2 * M_PI * iteration / iterations);
+                sweepY[iteration] = sin(2 * M_PI * iteration / iterations);
+            }
+
+            measure("SwerveTrain::getClockwiseREVRotationsFromCenter", iterations, [&](const int &iteration) {
+
+                return zion.getClockwiseREVRotationsFromCenter(Vec2d{sweepX[iteration], sweepY[iteration]});
+            });
+            measure("SwerveTrain::getStandardDegreeAngleFromCenter", iterations, [&](const int &iteration) {
+
+                return zion.getStandardDegreeAngleFromCenter(sweepX[iteration], sweepY[iteration]);
+            });
+            measure("::atan2", iterations, [&](const int &iteration) {
+
+                return ::atan2(sweepY[iteration], sweepX[iteration]);
+            });
+            measure("Angle::atan2", iterations, [&](const int &iteration) {
+
+                return Angle::atan2(sweepY[iteration], sweepX[iteration]);
+            });
+            measure("Angle::fastAtan2", iterations, [&](const int &iteration) {
+
+                return Angle::fastAtan2(sweepY[iteration], sweepX[iteration]);
+            });
+            measure("Angle::standardDegrees", iterations, [&](const int &iteration) {
+
+                return Angle::standardDegrees(sweepX[iteration], sweepY[iteration]);
+            });
+            measure("Vec2::norm", iterations, [&](const int &iteration) {
+
+                const Vec2d vector{sweepX[iteration], sweepY[iteration]};
+                return vector.norm();
+            });
+            measure("Vec2::rotate", iterations, [&](const int &iteration) {
+
+                const Vec2d vector{sweepX[iteration], sweepY[iteration]};
+                return vector.rotate(sweepX[iterations - 1 - iteration], sweepY[iterations - 1 - iteration]).i;
+            });
+            //Four modules' worth of the kinematics' add, scale, and norm, one
+            //module at a time and then all at once.
+            std::vector<Vec2f> sweepVectors(iterations + 3);
+            for (int iteration = 0; iteration < iterations + 3; iteration++) {
+
+                sweepVectors[iteration] = {(float)sweepX[iteration % iterations], (float)sweepY[iteration % iterations]};
+            }
+            measure("Vec2::norm4", iterations, [&](const int &iteration) {
+
+                const Vec2f translation{sweepVectors[iteration].j, sweepVectors[iteration].i};
+                float largest = 0;
+                for (int module = 0; module < 4; module++) {
+
+                    largest = fmaxf(largest, (translation + sweepVectors[iteration + module] * .5f).norm());
+                }
+                return largest;
+            });
+            measure("Vec2x4::norm", iterations, [&](const int &iteration) {
+
+                const Vec2f translation{sweepVectors[iteration].j, sweepVectors[iteration].i};
+                const Vec2x4 translations{Float4::broadcast(translation.i), Float4::broadcast(translation.j)};
+                return (translations + Vec2x4::load(&sweepVectors[iteration]) * .5f).norm().maxLane();
+            });
+            measure("SwerveModule::calculateAssumePositionSpeed", iterations, [&](const int &iteration) {
+
+                return frontRight.calculateAssumePositionSpeed(R_nicsConstant * (iteration - iterations / 2) / iterations);
+            });
+            //The same curve with exp() every call, as it was before its table.
+            measure("SwerveModule::calculateAssumePositionSpeed::Exp", iterations, [&](const int &iteration) {
+
+                return 1 / (1 + exp(-fabs(R_nicsConstant * (iteration - iterations / 2) / iterations) + 5));
+            });
+            measure("SwerveTrain::driveController", iterations, [&](const int &iteration) {
+
+                FakeAHRS::get()->setAngle(360. * iteration / iterations);
+                zion.driveController(controller);
+                zion.updateCommands();
+                return FakeSparkMax::get(R_CANIDZionFrontRightSwerve)->Get();
+            });
+        }
+
+        const std::map<std::string, double> &getResults() {
+
+            return m_results;
+        }
+        bool writeJson(const std::string &path) {
+
+            std::ofstream file(path);
+            if (!file) {
+
+                return false;
+            }
+            //One measurement per line, so readBaseline() can stay simple.
+            file << "{\n";
+            for (auto result = m_results.begin(); result != m_results.end(); result++) {
+
+                file << "    \"" << result->first << "\": " << result->second << (std::next(result) == m_results.end() ? "\n" : ",\n");
+            }
+            file << "}\n";
+            return file.good();
+        }
+        bool readBaseline(const std::string &path) {
+
+            std::ifstream file(path);
+            if (!file) {
+
+                return false;
+            }
+            std::string line;
+            while (std::getline(file, line)) {
+
+                const size_t nameStart = line.find('"');
+                const size_t nameEnd = line.find('"', nameStart + 1);
+                if (nameStart == std::string::npos || nameEnd == std::string::npos) {
+
+                    continue;
+                }
+                m_baseline[line.substr(nameStart + 1, nameEnd - nameStart - 1)] = atof(line.substr(line.find(':', nameEnd) + 1).c_str());
+            }
+            return true;
+        }
+        double getRatio(const std::string &name) {
+
+            if (m_results.count(name) == 0 || m_baseline.count(name) == 0 || m_baseline[name] == 0) {
+
+                return 0;
+            }
+            return m_results[name] / m_baseline[name];
+        }
+
+    private:
+        std::map<std::string, double> m_results;
+        std::map<std::string, double> m_baseline;
+
+        //Results are accumulated here so the measured work has a use.
+        volatile double m_sink;
+};
@@ -0,0 +1,37 @@
+#include <iostream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "Benchmark.h"
+#include "Controllers.h"
+
+//Times the drivetrain math, writes it out to keep as a baseline, and reports
+//it against the one kept, if any. See Benchmark.h. Timings are too noisy to
+//fail on, so this only fails if the results cannot be written.
+TEST(BenchmarkTest, Drivetrain) {
+
+    //The stick pushed partway, and twisted, so that driveController() has
+    //everything to work out.
+    ControllerState controller{};
+    controller.axes[ControllerState::kJoystickX] = .5;
+    controller.axes[ControllerState::kJoystickY] = -.5;
+    controller.axes[ControllerState::kJoystickZ] = .3;
+
+    Benchmark benchmark;
+    benchmark.runDrivetrain(controller);
+    const std::string source = __FILE__;
+    benchmark.readBaseline(source.substr(0, source.find_last_of('/') + 1) + "benchmark-baseline.json");
+    EXPECT_TRUE(benchmark.writeJson("benchmark.json"));
+
+    for (const auto &result : benchmark.getResults()) {
+
+        std::cout << result.first << ": " << result.second << " ns";
+        if (benchmark.getRatio(result.first) != 0) {
+
+            std::cout << " (" << benchmark.getRatio(result.first) << " of baseline)";
+        }
+        std::cout << std::endl;
+        ::testing::Test::RecordProperty(result.first, std::to_string(result.second));
+    }
+}
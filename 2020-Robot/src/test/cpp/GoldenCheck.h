@@ -0,0 +1,304 @@
+/*
+class GoldenCheck
+
+    Guards how Zion drives against faster rewrites of the drivetrain math.
+        It keeps frozen copies of the original angle, speed, and kinematics
+        calculations (the "golden" outputs) and sweeps dense grids of
+        joystick X, Y, and Z and NavX yaw through both them and whatever
+        SwerveTrain and SwerveModule currently do, recording the largest
+        difference of each. A rewrite passes if every difference stays
+        within its tolerance, so it changes how fast the robot
+        thinks and not how it drives. It runs against a swerve train built
+        on FakeDevices, as a test (see GoldenCheckTest.cpp), so every build
+        checks it.
+
+    Angles are compared as the shortest way around the circle, so 0 and one
+    full rotation are the same. Magnitudes are compared in ULPs (the number
+    of representable doubles between the two). Inputs the original math
+    returned NaN for are skipped and counted, since fixing those is allowed,
+    as are the positions of modules that are not driving.
+
+Constructors
+
+    GoldenCheck()
+        Creates a check with no results.
+
+Public Methods
+
+    void runDrivetrain()
+        Sweeps the angle conversions, Angle::fastAtan2(), Vec2 math, the swerve speed calculation, and calculateModuleTargets()
+        against their golden copies.
+    bool getPassed()
+        Returns true if every comparison so far was within tolerance.
+    const std::map<std::string, Result> &getResults()
+        Returns the largest difference, the number of skipped inputs, and
+        whether it passed, for each comparison by name.
+
+    struct Result
+        One comparison's maxError, skipped, and passed.
+
+Private Methods
+
+    void compare(const std::string&, const double&, const double&, const double&, const int&)
+        Records one golden and one current value under the supplied name,
+        with the supplied tolerance and Comparison.
+    static double goldenClockwiseREVRotationsFromCenter(const double&, const double&)
+    static double goldenStandardDegreeAngleFromCenter(const double&, const double&)
+    static double goldenUnitCircleAngleDeg(const double&, const double&)
+    static double goldenMagnitude(const double&, const double&)
+    static double goldenAssumePositionSpeed(const double&)
+    static void goldenModuleTargets(const double&, const double&, const double&, const double&, double[4], double[4])
+        The drivetrain math exactly as it was first written. Never change
+        these; they are what everything else is measured against.
+
+    enum Comparison
+        How compare() measures a difference: kAbsolute, kULP, or around the
+        circle in kRadians, kNics, or kDegrees.
+    kTolerance constants
+        The largest differences allowed between the current drivetrain math
+        and the original, in Nics, degrees, ULPs, absolute motor output, and
+        absolute module speed.
+*/
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+
+#include "Angle.h"
+#include "Devices.h"
+#include "FakeDevices.h"
+#include "NavX.h"
+#include "RobotMap.h"
+#include "SwerveModule.h"
+#include "SwerveTrain.h"
+#include "Vec2.h"
+
+class GoldenCheck {
+
+    public:
+        struct Result {
+
+            double maxError = 0;
+            int skipped = 0;
+            bool passed = true;
+        };
+
+        GoldenCheck() {}
+
+        void runDrivetrain() {
+
+            BasicNavX<FakeDevices> navX(BasicNavX<FakeDevices>::kMXP);
+            BasicSwerveModule<FakeDevices> frontRight(R_CANIDZionFrontRightDrive, R_CANIDZionFrontRightSwerve);
+            BasicSwerveModule<FakeDevices> frontLeft(R_CANIDZionFrontLeftDrive, R_CANIDZionFrontLeftSwerve);
+            BasicSwerveModule<FakeDevices> rearLeft(R_CANIDZionRearLeftDrive, R_CANIDZionRearLeftSwerve);
+            BasicSwerveModule<FakeDevices> rearRight(R_CANIDZionRearRightDrive, R_CANIDZionRearRightSwerve);
+            BasicSwerveTrain<FakeDevices> zion(frontRight, frontLeft, rearLeft, rearRight, navX);
+
+            //The angle and vector math, over a dense grid of the unit square...
+            for (int xStep = -100; xStep <= 100; xStep++) {
+
+                for (int yStep = -100; yStep <= 100; yStep++) {
+
+                    const double x = xStep / 100.;
+                    const double y = yStep / 100.;
+                    const Vec2d vector{x, y};
+
+                    compare("SwerveTrain::getClockwiseREVRotationsFromCenter", goldenClockwiseREVRotationsFromCenter(x, y), zion.getClockwiseREVRotationsFromCenter(vector), kToleranceNics, kNics);
+                    compare("SwerveTrain::getStandardDegreeAngleFromCenter", goldenStandardDegreeAngleFromCenter(x, y), zion.getStandardDegreeAngleFromCenter(x, y), kToleranceDegrees, kDegrees);
+                    compare("Angle::standardDegrees", goldenUnitCircleAngleDeg(x, y), Angle::standardDegrees(vector.i, vector.j), kToleranceDegrees, kDegrees);
+                    compare("Vec2::norm", goldenMagnitude(x, y), vector.norm(), kToleranceULPs, kULP);
+                    //The fast arctangent is held to its own documented bound,
+                    //whether or not it is switched on.
+                    compare("Angle::fastAtan2", atan2(y, x), Angle::fastAtan2(y, x), R_angleFastAtan2MaxError, kRadians);
+                }
+            }
+
+            //The swerve speed, over more than a full rotation either way...
+            for (int step = -10000; step <= 10000; step++) {
+
+                const double remaining = R_nicsConstant * step / 10000.;
+                compare("SwerveModule::calculateAssumePositionSpeed", goldenAssumePositionSpeed(remaining), frontRight.calculateAssumePositionSpeed(remaining), kToleranceSpeed, kAbsolute);
+            }
+
+            //And the full kinematics, over the joystick and every heading.
+            for (int xStep = -10; xStep <= 10; xStep++) {
+
+                for (int yStep = -10; yStep <= 10; yStep++) {
+
+                    for (int zStep = -4; zStep <= 4; zStep++) {
+
+                        for (int angleStep = 0; angleStep < 24; angleStep++) {
+
+                            const double x = xStep / 10.;
+                            const double y = yStep / 10.;
+                            const double z = zStep / 4.;
+                            const double angle = angleStep * 15.;
+
+                            double goldenPositions[4];
+                            double goldenSpeeds[4];
+                            double positions[4];
+                            double speeds[4];
+                            goldenModuleTargets(x, y, z, angle, goldenPositions, goldenSpeeds);
+                            zion.calculateModuleTargets(x, y, z, angle, positions, speeds);
+                            for (int module = 0; module < 4; module++) {
+
+                                //A stopped module's position is skipped, like NaN.
+                                compare("SwerveTrain::calculateModuleTargets::Position", goldenSpeeds[module] < kToleranceModuleSpeed ? NAN : goldenPositions[module], positions[module], kToleranceNics, kNics);
+                                compare("SwerveTrain::calculateModuleTargets::Speed", goldenSpeeds[module], speeds[module], kToleranceModuleSpeed, kAbsolute);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        bool getPassed() {
+
+            for (const auto &result : m_results) {
+
+                if (!result.second.passed) {
+
+                    return false;
+                }
+            }
+            return true;
+        }
+        const std::map<std::string, Result> &getResults() {
+
+            return m_results;
+        }
+
+    private:
+        enum Comparison {
+
+            kAbsolute, kULP, kRadians, kNics, kDegrees
+        };
+
+        static constexpr double kToleranceNics = .0001;
+        static constexpr double kToleranceDegrees = kToleranceNics / R_nicsConstant * 360;
+        static constexpr double kToleranceULPs = 4;
+        static constexpr double kToleranceSpeed = .001;
+        //Module speeds are sums of rotated vectors, so any reordering of the
+        //math moves them by rounding error that can be many ULPs when a sum
+        //nearly cancels. They are held to this absolute difference instead,
+        //and module positions are not checked where the speed is below it,
+        //since a wheel that is not driving can point anywhere.
+        static constexpr double kToleranceModuleSpeed = .000000000001;
+
+        void compare(const std::string &name, const double &golden, const double &current, const double &tolerance, const int &comparison) {
+
+            Result &result = m_results[name];
+            //The original math had NaN edge cases; anything is better.
+            if (isnan(golden)) {
+
+                result.skipped++;
+                return;
+            }
+
+            double error = 0;
+            switch (comparison) {
+
+                case kAbsolute: error = fabs(current - golden); break;
+                case kULP: {
+
+                    //Doubles of the same sign are ordered like their bits.
+                    int64_t goldenBits;
+                    int64_t currentBits;
+                    memcpy(&goldenBits, &golden, sizeof(double));
+                    memcpy(&currentBits, &current, sizeof(double));
+                    if (goldenBits < 0) {goldenBits = INT64_MIN - goldenBits;}
+                    if (currentBits < 0) {currentBits = INT64_MIN - currentBits;}
+                    //Subtract before converting, since a double cannot
+                    //hold every int64_t and would round away small errors.
+                    error = fabs((double)(goldenBits - currentBits));
+                    break;
+                }
+                case kRadians: error = fabs(remainder(current - golden, 2 * M_PI)); break;
+                case kNics: error = fabs(remainder(current - golden, R_nicsConstant)); break;
+                case kDegrees: error = fabs(remainder(current - golden, 360)); break;
+            }
+
+            //A NaN error is as bad as it gets.
+            if (isnan(error) || error > tolerance) {
+
+                result.passed = false;
+            }
+            if (isnan(error) || error > result.maxError) {
+
+                result.maxError = error;
+            }
+        }
+
+        static double goldenClockwiseREVRotationsFromCenter(const double &x, const double &y) {
+
+            const double dotProduct = (0 * x) + (1 * y);
+            const double magnitudeProduct = sqrt(pow(0, 2) + pow(1, 2)) * sqrt(pow(x, 2) + pow(y, 2));
+            const double cosineAngle = dotProduct / magnitudeProduct;
+            double angleRad = acos(cosineAngle);
+            if (magnitudeProduct == 0) {
+
+                angleRad = 0;
+            }
+            if (x < 0) {
+
+                angleRad = (2 * M_PI) - angleRad;
+            }
+            return ((angleRad) / (2 * M_PI)) * R_nicsConstant;
+        }
+        static double goldenStandardDegreeAngleFromCenter(const double &x, const double &y) {
+
+            return goldenClockwiseREVRotationsFromCenter(x, y) / R_nicsConstant * 360.;
+        }
+        static double goldenUnitCircleAngleDeg(const double &i, const double &j) {
+
+            double calculatedAngle = 0;
+            if (i > 0 && j > 0) {calculatedAngle = atan(j / i) * (180 / M_PI);}
+            else if (i < 0 && j > 0) {calculatedAngle = 180 - atan(j / -i) * (180 / M_PI);}
+            else if (i < 0 && j < 0) {calculatedAngle = 180 + atan(-j / -i) * (180 / M_PI);}
+            else if (i > 0 && j < 0) {calculatedAngle = 360 - atan(-j / i) * (180 / M_PI);}
+            else if (i == 0 && j > 0) {calculatedAngle = 90;}
+            else if (i == 0 && j < 0) {calculatedAngle = 270;}
+            else if (i > 0 && j == 0) {calculatedAngle = 0;}
+            else if (i < 0 && j == 0) {calculatedAngle = 180;}
+            return calculatedAngle;
+        }
+        static double goldenMagnitude(const double &i, const double &j) {
+
+            return sqrt(pow(i, 2) + pow(j, 2));
+        }
+        static double goldenAssumePositionSpeed(const double &howFarRemainingInTravel) {
+
+            double toReturn = ((1) / (1 + exp((-1 * fabs(howFarRemainingInTravel)) + 5)));
+            if (fabs(howFarRemainingInTravel) < R_swerveTrainAssumePositionSpeedCalculationFirstEndBehaviorAt) {
+
+                toReturn = R_swerveTrainAssumePositionSpeedCalculationFirstEndBehaviorSpeed;
+            }
+            if (fabs(howFarRemainingInTravel) < R_swerveTrainAssumePositionSpeedCalculationSecondEndBehaviorAt) {
+
+                toReturn = R_swerveTrainAssumePositionSpeedCalculationSecondEndBehaviorSpeed;
+            }
+            if (howFarRemainingInTravel < 0) {
+
+                toReturn = -toReturn;
+            }
+            return toReturn;
+        }
+        static void goldenModuleTargets(const double &x, const double &y, const double &z, const double &angle, double positions[4], double speeds[4]) {
+
+            const double wheelAngles[4] = {R_angleFromCenterToFrontRightWheel, R_angleFromCenterToFrontLeftWheel, R_angleFromCenterToRearLeftWheel, R_angleFromCenterToRearRightWheel};
+            for (int module = 0; module < 4; module++) {
+
+                const double i = -x + z * cos((wheelAngles[module] - angle) * (M_PI / 180));
+                const double j = y + z * sin((wheelAngles[module] - angle) * (M_PI / 180));
+                positions[module] = R_nicsConstant * (goldenUnitCircleAngleDeg(i, j) + angle - 90.) / 360.;
+                speeds[module] = goldenMagnitude(i, j);
+            }
+        }
+
+        std::map<std::string, Result> m_results;
+};
@@ -0,0 +1,16 @@
+#include "gtest/gtest.h"
+
+#include "GoldenCheck.h"
+
+//The drivetrain math, however fast it has been made, has to drive Zion exactly
+//as the original did. See GoldenCheck.h.
+TEST(GoldenCheckTest, DrivetrainMatchesGolden) {
+
+    GoldenCheck goldenCheck;
+    goldenCheck.runDrivetrain();
+    for (const auto &result : goldenCheck.getResults()) {
+
+        EXPECT_TRUE(result.second.passed) << result.first << " is off by " << result.second.maxError << " (" << result.second.skipped << " skipped)";
+    }
+    EXPECT_TRUE(goldenCheck.getPassed());
+}
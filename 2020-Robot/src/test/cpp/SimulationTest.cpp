@@ -0,0 +1,164 @@
+#include <math.h>
+
+#include "gtest/gtest.h"
+
+#include "FakeDevices.h"
+#include "Hal.h"
+#include "Intake.h"
+#include "Launcher.h"
+#include "Limelight.h"
+#include "NavX.h"
+#include "RobotMap.h"
+#include "Simulation.h"
+#include "SwerveModule.h"
+#include "SwerveTrain.h"
+
+//Zion and Hal on fake devices, driving a Simulation the way the robot runs
+//them: Hal and the drive task once a loop, and the steering task as often as
+//the Scheduler runs it (see Robot.cpp).
+class SimulationTest : public ::testing::Test {
+
+    protected:
+        SimulationTest() :
+            m_navX(BasicNavX<FakeDevices>::kMXP),
+            m_frontRight(R_CANIDZionFrontRightDrive, R_CANIDZionFrontRightSwerve),
+            m_frontLeft(R_CANIDZionFrontLeftDrive, R_CANIDZionFrontLeftSwerve),
+            m_rearLeft(R_CANIDZionRearLeftDrive, R_CANIDZionRearLeftSwerve),
+            m_rearRight(R_CANIDZionRearRightDrive, R_CANIDZionRearRightSwerve),
+            m_zion(m_frontRight, m_frontLeft, m_rearLeft, m_rearRight, m_navX),
+            m_intake(R_CANIDMotorIntake),
+            m_launcher(R_CANIDMotorLauncherIndex, R_CANIDMotorLauncherLaunchOne, R_CANIDMotorLauncherLaunchTwo),
+            m_hal(m_intake, m_launcher, m_limelight, m_navX, m_zion),
+            m_simulation(m_startX, m_startY, m_startHeading) {}
+
+        //Runs the rest of one loop, after whatever Hal did in it.
+        void finishLoop() {
+
+            m_zion.updateCommands();
+            const int steeringSteps = (int)lround(R_robotLoopPeriod / R_schedulerSteeringPeriod);
+            for (int step = 0; step < steeringSteps; step++) {
+
+                m_zion.updateSteering();
+                m_simulation.stepDevices(R_robotLoopPeriod / steeringSteps);
+            }
+        }
+
+        //Out in the open, facing down the field.
+        const double m_startX = 200;
+        const double m_startY = 150;
+        const double m_startHeading = 90;
+
+        BasicNavX<FakeDevices> m_navX;
+        BasicSwerveModule<FakeDevices> m_frontRight;
+        BasicSwerveModule<FakeDevices> m_frontLeft;
+        BasicSwerveModule<FakeDevices> m_rearLeft;
+        BasicSwerveModule<FakeDevices> m_rearRight;
+        BasicSwerveTrain<FakeDevices> m_zion;
+        BasicIntake<FakeDevices> m_intake;
+        BasicLauncher<FakeDevices> m_launcher;
+        Limelight m_limelight;
+        BasicHal<FakeDevices> m_hal;
+        Simulation m_simulation;
+};
+
+//The whole routine has to finish, turned a quarter and moved about as far as
+//it measures (30 inches to the side, then 60 forward), without running into
+//anything.
+TEST_F(SimulationTest, ShootingPositionToTrenchGrab) {
+
+    bool done = false;
+    for (int loop = 0; loop < 15 / R_robotLoopPeriod && !done; loop++) {
+
+        done = m_hal.zionShootingPositionToTrenchGrab();
+        finishLoop();
+    }
+    ASSERT_TRUE(done) << "Still running after " << m_simulation.getElapsedTime() << " seconds";
+
+    //Hal stops turning once within its tolerance of a quarter, and Zion
+    //carries on turning while the wheels stop, so allow for as much again.
+    EXPECT_NEAR(m_simulation.getHeading() - m_startHeading, 90, 2 * R_zionAutoToleranceAngle);
+    EXPECT_EQ(m_simulation.getCollisionCount(), 0);
+    //The two legs are square to each other, so Zion ends up at least their
+    //diagonal away, and, coasting past each a little, no further than both.
+    const double distance = hypot(m_simulation.getX() - m_startX, m_simulation.getY() - m_startY);
+    EXPECT_GE(distance, hypot(30, 60));
+    EXPECT_LE(distance, 30 + 60);
+}
+
+//Steering is only as fresh as the positions the swerves send.
+TEST_F(SimulationTest, SwervesSendPositionsAsOftenAsSteered) {
+
+    for (const int &canID : {R_CANIDZionFrontRightSwerve, R_CANIDZionFrontLeftSwerve, R_CANIDZionRearLeftSwerve, R_CANIDZionRearRightSwerve}) {
+
+        EXPECT_EQ(FakeSparkMax::get(canID)->getPeriodicFramePeriod(FakeSparkMax::PeriodicFrame::kStatus2), R_schedulerSteeringFramePeriod);
+    }
+}
+
+//Only the steering thread sets the swerves, so a stop always lands, and once
+//the drivetrain's thread goes quiet it stops them itself.
+TEST_F(SimulationTest, SwervesStop) {
+
+    const int swerves[4] = {R_CANIDZionFrontRightSwerve, R_CANIDZionFrontLeftSwerve, R_CANIDZionRearLeftSwerve, R_CANIDZionRearRightSwerve};
+    const DriveCommand turn = DriveCommand::fromSource(DriveCommand::kHal, ChassisSpeeds::fromFractions(0, 0, R_zionAutoMovementSpeedLateral), false);
+
+    //Turning in place from straight has every swerve turning...
+    m_zion.submit(turn);
+    finishLoop();
+    for (const int &canID : swerves) {
+
+        EXPECT_NE(FakeSparkMax::get(canID)->Get(), 0);
+    }
+    //Until a stop...
+    m_zion.submit(DriveCommand::stopFromSource(DriveCommand::kHal));
+    finishLoop();
+    for (const int &canID : swerves) {
+
+        EXPECT_EQ(FakeSparkMax::get(canID)->Get(), 0);
+    }
+
+    //Or until nothing new comes for long enough.
+    m_zion.submit(turn);
+    finishLoop();
+    const int steeringSteps = (int)lround((R_swerveTrainSteeringTimeout + 1) * R_robotLoopPeriod / R_schedulerSteeringPeriod);
+    for (int step = 0; step < steeringSteps; step++) {
+
+        m_zion.updateSteering();
+    }
+    for (const int &canID : swerves) {
+
+        EXPECT_EQ(FakeSparkMax::get(canID)->Get(), 0);
+    }
+}
+
+//Calibrating by hand: a held button turns only its swerve, and letting go
+//stops it and sets the zeros where the swerves stopped.
+TEST_F(SimulationTest, ZeroController) {
+
+    ControllerState held{};
+    held.axes[ControllerState::kJoystickZ] = -1;
+    held.buttons = ControllerState::getMask(R_zeroButtonFL);
+    for (int loop = 0; loop < 10; loop++) {
+
+        m_zion.zeroController(held);
+        finishLoop();
+    }
+    EXPECT_NE(FakeSparkMax::get(R_CANIDZionFrontLeftSwerve)->Get(), 0);
+    EXPECT_EQ(FakeSparkMax::get(R_CANIDZionFrontRightSwerve)->Get(), 0);
+    EXPECT_NE(m_zion.m_frontLeft->getSwervePosition(), m_zion.m_frontLeft->getSwerveZeroPosition());
+
+    ControllerState released{};
+    released.released = ControllerState::getMask(R_zeroButtonFL);
+    m_zion.zeroController(released);
+    finishLoop();
+    EXPECT_EQ(FakeSparkMax::get(R_CANIDZionFrontLeftSwerve)->Get(), 0);
+    const double zero = m_zion.m_frontLeft->getSwerveZeroPosition();
+
+    //And nothing changes while nothing is held.
+    for (int loop = 0; loop < 10; loop++) {
+
+        m_zion.zeroController(ControllerState{});
+        finishLoop();
+    }
+    EXPECT_EQ(FakeSparkMax::get(R_CANIDZionFrontLeftSwerve)->Get(), 0);
+    EXPECT_EQ(m_zion.m_frontLeft->getSwerveZeroPosition(), zero);
+}